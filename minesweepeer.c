@@ -1,27 +1,33 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <string.h>
 #include <math.h>
 #include <raylib.h>
 
-#define SIZE 6
-#define MINES 8
-#define CELL_SIZE 60
-#define PADDING 20
-#define WINDOW_WIDTH 520
-#define WINDOW_HEIGHT 720
+#include "minesweeper_board.h"
 
-typedef struct {
-    int isMine;
-    int isRevealed;
-    int isFlagged;
-    int adjacentMines;
-} Cell;
+// Board used when no size is given on the command line
+#define DEFAULT_WIDTH 6
+#define DEFAULT_HEIGHT 6
+#define DEFAULT_MINES 8
+
+// Cells shrink from the largest size until the board fits the window limits
+#define MAX_CELL_SIZE 60
+#define MIN_CELL_SIZE 12
+#define MAX_WINDOW_WIDTH 1600
+#define MAX_WINDOW_HEIGHT 1000
+#define MIN_WINDOW_WIDTH 520
+#define PADDING 20
+// Room below the board for the status line, buttons and result
+#define UI_HEIGHT 340
 
 typedef struct {
-    Cell board[SIZE][SIZE];
+    Board board;
+    BoardRandom random;
+    // Seed of the current board, shown so it can be replayed with --seed
+    uint64_t seed;
+    int minesPlaced;
     int minesRemaining;
     int cellsRevealed;
     int gameOver;
@@ -40,65 +46,52 @@ typedef struct {
 Game game;
 Button resetButton;
 Button quitButton;
+int cellSize = MAX_CELL_SIZE;
+int windowWidth;
+int windowHeight;
+// The board is drawn into this texture and only changed cells are redrawn
+RenderTexture2D boardTexture;
 
 void initializeBoard(Game *game) {
-    // Initialize all cells
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            game->board[i][j].isMine = 0;
-            game->board[i][j].isRevealed = 0;
-            game->board[i][j].isFlagged = 0;
-            game->board[i][j].adjacentMines = 0;
-        }
-    }
+    Board *board = &game->board;
     
-    // Place mines randomly
-    int minesPlaced = 0;
-    while (minesPlaced < MINES) {
-        int row = rand() % SIZE;
-        int col = rand() % SIZE;
-        if (!game->board[row][col].isMine) {
-            game->board[row][col].isMine = 1;
-            minesPlaced++;
-        }
-    }
-    
-    // Calculate adjacent mines for each cell
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            if (!game->board[i][j].isMine) {
-                int count = 0;
-                for (int di = -1; di <= 1; di++) {
-                    for (int dj = -1; dj <= 1; dj++) {
-                        int ni = i + di;
-                        int nj = j + dj;
-                        if (ni >= 0 && ni < SIZE && nj >= 0 && nj < SIZE) {
-                            if (game->board[ni][nj].isMine) {
-                                count++;
-                            }
-                        }
-                    }
-                }
-                game->board[i][j].adjacentMines = count;
-            }
-        }
-    }
+    // Initialize all cells; mines are placed by the first reveal
+    resetBoard(board);
+    game->minesPlaced = 0;
     
-    game->minesRemaining = MINES;
+    game->minesRemaining = board->mines;
     game->cellsRevealed = 0;
     game->gameOver = 0;
     game->won = 0;
     game->lost = 0;
 }
 
+// Pick the cell size and window size for the board; returns 0, or -1 if
+// even the smallest cells don't fit
+int computeLayout(const Board *board) {
+    cellSize = MAX_CELL_SIZE;
+    while (cellSize > MIN_CELL_SIZE &&
+           (2 * PADDING + board->width * cellSize > MAX_WINDOW_WIDTH ||
+            PADDING + board->height * cellSize + UI_HEIGHT > MAX_WINDOW_HEIGHT)) {
+        cellSize--;
+    }
+    windowWidth = 2 * PADDING + board->width * cellSize;
+    if (windowWidth < MIN_WINDOW_WIDTH) {
+        windowWidth = MIN_WINDOW_WIDTH;
+    }
+    windowHeight = PADDING + board->height * cellSize + UI_HEIGHT;
+    return (windowWidth <= MAX_WINDOW_WIDTH && windowHeight <= MAX_WINDOW_HEIGHT) ? 0 : -1;
+}
+
 void initializeButtons() {
-    resetButton.rect = (Rectangle){PADDING, SIZE * CELL_SIZE + PADDING + 40, 100, 40};
+    int boardBottom = PADDING + game.board.height * cellSize;
+    resetButton.rect = (Rectangle){PADDING, boardBottom + 40, 100, 40};
     resetButton.text = "RESET";
     resetButton.color = GREEN;
     resetButton.hoverColor = LIME;
     resetButton.isHovered = 0;
     
-    quitButton.rect = (Rectangle){WINDOW_WIDTH - PADDING - 100, SIZE * CELL_SIZE + PADDING + 40, 100, 40};
+    quitButton.rect = (Rectangle){windowWidth - PADDING - 100, boardBottom + 40, 100, 40};
     quitButton.text = "QUIT";
     quitButton.color = RED;
     quitButton.hoverColor = MAROON;
@@ -123,131 +116,158 @@ void drawButton(Button *button) {
 }
 
 void drawCell(int row, int col, int x, int y) {
-    Cell *cell = &game.board[row][col];
+    const Board *board = &game.board;
+    int adjacentMines = boardAdjacentMines(board, row, col);
     Color cellColor = LIGHTGRAY;
     Color borderColor = DARKGRAY;
     
+    // Marks scale with the cell; at the largest size the font is 30
+    int fontSize = cellSize / 2;
+    
     // Draw cell background
-    DrawRectangle(x, y, CELL_SIZE, CELL_SIZE, cellColor);
-    DrawRectangleLines(x, y, CELL_SIZE, CELL_SIZE, borderColor);
+    DrawRectangle(x, y, cellSize, cellSize, cellColor);
+    DrawRectangleLines(x, y, cellSize, cellSize, borderColor);
     
-    if (cell->isRevealed) {
-        if (cell->isMine) {
+    if (boardIsRevealed(board, row, col)) {
+        if (boardIsMine(board, row, col)) {
             // Draw mine
-            DrawCircle(x + CELL_SIZE / 2, y + CELL_SIZE / 2, 15, RED);
-            DrawCircle(x + CELL_SIZE / 2, y + CELL_SIZE / 2, 12, DARKRED);
-        } else if (cell->adjacentMines > 0) {
+            DrawCircle(x + cellSize / 2, y + cellSize / 2, cellSize / 4, RED);
+            DrawCircle(x + cellSize / 2, y + cellSize / 2, cellSize / 5, DARKRED);
+        } else if (adjacentMines > 0) {
             // Draw number
-            char numStr[2];
-            sprintf(numStr, "%d", cell->adjacentMines);
-            int textWidth = MeasureText(numStr, 30);
-            DrawText(numStr, x + CELL_SIZE / 2 - textWidth / 2, y + CELL_SIZE / 2 - 15, 30, BLUE);
+            char numStr[4];
+            sprintf(numStr, "%d", adjacentMines);
+            int textWidth = MeasureText(numStr, fontSize);
+            DrawText(numStr, x + cellSize / 2 - textWidth / 2, y + cellSize / 2 - fontSize / 2, fontSize, BLUE);
         } else {
             // Empty cell (0 adjacent mines)
-            DrawRectangle(x + 2, y + 2, CELL_SIZE - 4, CELL_SIZE - 4, WHITE);
+            DrawRectangle(x + 2, y + 2, cellSize - 4, cellSize - 4, WHITE);
         }
     } else {
         // Unrevealed cell
-        DrawRectangleGradientV(x + 2, y + 2, CELL_SIZE - 4, CELL_SIZE - 4, LIGHTGRAY, GRAY);
+        DrawRectangleGradientV(x + 2, y + 2, cellSize - 4, cellSize - 4, LIGHTGRAY, GRAY);
         
-        if (cell->isFlagged) {
+        if (boardIsFlagged(board, row, col)) {
             // Draw flag
-            DrawTriangle((Vector2){x + CELL_SIZE / 2 + 5, y + 10},
-                        (Vector2){x + CELL_SIZE / 2 + 5, y + 25},
-                        (Vector2){x + CELL_SIZE / 2 + 20, y + 17}, YELLOW);
+            DrawTriangle((Vector2){x + cellSize / 2 + cellSize / 12, y + cellSize / 6},
+                        (Vector2){x + cellSize / 2 + cellSize / 12, y + cellSize * 5 / 12},
+                        (Vector2){x + cellSize / 2 + cellSize / 3, y + cellSize * 17 / 60}, YELLOW);
         } else {
-            DrawText("?", x + CELL_SIZE / 2 - 10, y + CELL_SIZE / 2 - 15, 30, DARKGRAY);
+            DrawText("?", x + cellSize / 2 - cellSize / 6, y + cellSize / 2 - fontSize / 2, fontSize, DARKGRAY);
         }
     }
 }
 
-void drawBoard() {
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            int x = PADDING + j * CELL_SIZE;
-            int y = PADDING + i * CELL_SIZE;
-            drawCell(i, j, x, y);
-        }
+// Redraw cells first..last of a row in the board texture
+void redrawCells(int row, int first, int last) {
+    BeginTextureMode(boardTexture);
+    for (int j = first; j <= last; j++) {
+        drawCell(row, j, j * cellSize, row * cellSize);
     }
+    EndTextureMode();
 }
 
-void floodFill(int row, int col) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
-        return;
+void redrawBoard() {
+    for (int i = 0; i < game.board.height; i++) {
+        redrawCells(i, 0, game.board.width - 1);
     }
-    
-    if (game.board[row][col].isRevealed) {
-        return;
+}
+
+void drawBoard() {
+    // Render textures are stored upside down, hence the negative height
+    Rectangle source = {0, 0, boardTexture.texture.width, -boardTexture.texture.height};
+    DrawTextureRec(boardTexture.texture, source, (Vector2){PADDING, PADDING}, WHITE);
+}
+
+void floodFill(int row, int col) {
+    int revealed = floodReveal(&game.board, row, col);
+    if (revealed < 0) {
+        fprintf(stderr, "Error: out of memory while revealing cells\n");
+        exit(1);
     }
-    
-    game.board[row][col].isRevealed = 1;
-    game.cellsRevealed++;
-    
-    if (game.board[row][col].adjacentMines == 0) {
-        for (int di = -1; di <= 1; di++) {
-            for (int dj = -1; dj <= 1; dj++) {
-                floodFill(row + di, col + dj);
-            }
-        }
+    game.cellsRevealed += revealed;
+    for (size_t s = 0; s < game.board.spanCount; s++) {
+        const RevealSpan *span = &game.board.spans[s];
+        redrawCells(span->row, span->first, span->last);
     }
 }
 
 void revealCell(int row, int col) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+    if (row < 0 || row >= game.board.height || col < 0 || col >= game.board.width) {
         return;
     }
     
-    if (game.board[row][col].isRevealed || game.board[row][col].isFlagged) {
+    if (boardIsRevealed(&game.board, row, col) || boardIsFlagged(&game.board, row, col)) {
         return;
     }
     
-    if (game.board[row][col].isMine) {
-        game.board[row][col].isRevealed = 1;
+    // The first click is always safe: mines go around it
+    if (!game.minesPlaced) {
+        placeMines(&game.board, &game.random, row, col);
+        game.minesPlaced = 1;
+    }
+    
+    if (boardIsMine(&game.board, row, col)) {
         game.lost = 1;
         game.gameOver = 1;
         // Reveal all mines
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                if (game.board[i][j].isMine) {
-                    game.board[i][j].isRevealed = 1;
-                }
-            }
+        for (size_t i = 0; i < game.board.planeWords; i++) {
+            game.board.revealed[i] |= game.board.mine[i];
         }
+        redrawBoard();
         return;
     }
     
     floodFill(row, col);
     
-    if (game.cellsRevealed == (SIZE * SIZE - MINES)) {
+    if (hiddenSafeCells(&game.board) == 0) {
         game.won = 1;
         game.gameOver = 1;
     }
 }
 
 void toggleFlag(int row, int col) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+    if (row < 0 || row >= game.board.height || col < 0 || col >= game.board.width) {
         return;
     }
     
-    if (game.board[row][col].isRevealed) {
+    if (boardIsRevealed(&game.board, row, col)) {
         return;
     }
     
-    game.board[row][col].isFlagged = !game.board[row][col].isFlagged;
-    if (game.board[row][col].isFlagged) {
+    boardToggleFlag(&game.board, row, col);
+    redrawCells(row, col, col);
+    if (boardIsFlagged(&game.board, row, col)) {
         game.minesRemaining--;
     } else {
         game.minesRemaining++;
     }
 }
 
+// Find the board cell under the mouse; returns 0 if it is off the board
+int cellUnderMouse(int *row, int *col) {
+    Vector2 mousePos = GetMousePosition();
+    int x = (int)floorf(mousePos.x) - PADDING;
+    int y = (int)floorf(mousePos.y) - PADDING;
+    if (x < 0 || y < 0 || x >= game.board.width * cellSize || y >= game.board.height * cellSize) {
+        return 0;
+    }
+    *row = y / cellSize;
+    *col = x / cellSize;
+    return 1;
+}
+
 void handleMouseInput() {
+    int row, col;
+    
     if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-        Vector2 mousePos = GetMousePosition();
-        
         // Check reset button
         if (isMouseOverButton(&resetButton)) {
+            // Draw the next seed from the current one so every board can be replayed
+            game.seed = nextBoardRandom(&game.random);
+            seedBoardRandom(&game.random, game.seed);
             initializeBoard(&game);
+            redrawBoard();
             return;
         }
         
@@ -257,78 +277,91 @@ void handleMouseInput() {
         }
         
         // Check board cells
-        if (!game.gameOver) {
-            for (int i = 0; i < SIZE; i++) {
-                for (int j = 0; j < SIZE; j++) {
-                    int x = PADDING + j * CELL_SIZE;
-                    int y = PADDING + i * CELL_SIZE;
-                    Rectangle cellRect = {x, y, CELL_SIZE, CELL_SIZE};
-                    
-                    if (CheckCollisionPointRec(mousePos, cellRect)) {
-                        revealCell(i, j);
-                        return;
-                    }
-                }
-            }
+        if (!game.gameOver && cellUnderMouse(&row, &col)) {
+            revealCell(row, col);
+            return;
         }
     }
     
     if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) {
-        Vector2 mousePos = GetMousePosition();
-        
         // Check board cells
-        if (!game.gameOver) {
-            for (int i = 0; i < SIZE; i++) {
-                for (int j = 0; j < SIZE; j++) {
-                    int x = PADDING + j * CELL_SIZE;
-                    int y = PADDING + i * CELL_SIZE;
-                    Rectangle cellRect = {x, y, CELL_SIZE, CELL_SIZE};
-                    
-                    if (CheckCollisionPointRec(mousePos, cellRect)) {
-                        toggleFlag(i, j);
-                        return;
-                    }
-                }
-            }
+        if (!game.gameOver && cellUnderMouse(&row, &col)) {
+            toggleFlag(row, col);
+            return;
         }
     }
 }
 
 void drawUI() {
+    int boardBottom = PADDING + game.board.height * cellSize;
+    
     // Draw title
-    const char *title = "MINESWEEPER 6x6";
+    char title[48];
+    sprintf(title, "MINESWEEPER %dx%d", game.board.width, game.board.height);
     int titleWidth = MeasureText(title, 40);
-    DrawText(title, WINDOW_WIDTH / 2 - titleWidth / 2, 10, 40, DARKBLUE);
+    DrawText(title, windowWidth / 2 - titleWidth / 2, 10, 40, DARKBLUE);
     
     // Draw mines remaining
     char minesText[32];
     sprintf(minesText, "Mines: %d", game.minesRemaining);
-    DrawText(minesText, PADDING, SIZE * CELL_SIZE + PADDING + 10, 20, BLACK);
+    DrawText(minesText, PADDING, boardBottom + 10, 20, BLACK);
     
     // Draw game status
     if (game.gameOver) {
         if (game.won) {
-            DrawText("YOU WON!", WINDOW_WIDTH / 2 - 80, SIZE * CELL_SIZE + PADDING + 90, 30, GREEN);
+            DrawText("YOU WON!", windowWidth / 2 - 80, boardBottom + 90, 30, GREEN);
         } else {
-            DrawText("GAME OVER!", WINDOW_WIDTH / 2 - 90, SIZE * CELL_SIZE + PADDING + 90, 30, RED);
+            DrawText("GAME OVER!", windowWidth / 2 - 90, boardBottom + 90, 30, RED);
         }
     } else {
         char cellsText[32];
         sprintf(cellsText, "Revealed: %d", game.cellsRevealed);
-        DrawText(cellsText, WINDOW_WIDTH / 2 - 60, SIZE * CELL_SIZE + PADDING + 10, 20, BLACK);
+        DrawText(cellsText, windowWidth / 2 - 60, boardBottom + 10, 20, BLACK);
     }
     
+    // Draw the seed of this board
+    char seedText[40];
+    sprintf(seedText, "Seed: %llu", (unsigned long long)game.seed);
+    DrawText(seedText, PADDING, boardBottom + 140, 20, LIGHTGRAY);
+    
     // Draw buttons
     drawButton(&resetButton);
     drawButton(&quitButton);
 }
 
-int main() {
-    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Minesweeper Game");
+int main(int argc, char *argv[]) {
+    BoardOptions options = {DEFAULT_WIDTH, DEFAULT_HEIGHT, DEFAULT_MINES, 0, 0};
+    
+    if (parseBoardOptions(argc, argv, &options) != 0) {
+        return 1;
+    }
+    if (!options.seeded) {
+        options.seed = defaultBoardSeed();
+    }
+    int width = options.width;
+    int height = options.height;
+    int mines = options.mines;
+    if (initBoard(&game.board, width, height, mines) != 0) {
+        fprintf(stderr, "Error: could not allocate a %dx%d board\n", width, height);
+        return 1;
+    }
+    if (computeLayout(&game.board) != 0) {
+        fprintf(stderr, "Error: a %dx%d board does not fit on screen; use the terminal version\n",
+                width, height);
+        freeBoard(&game.board);
+        return 1;
+    }
+    
+    InitWindow(windowWidth, windowHeight, "Minesweeper Game");
     SetTargetFPS(60);
     
-    srand(time(NULL));
+    boardTexture = LoadRenderTexture(width * cellSize, height * cellSize);
+    
+    game.seed = options.seed;
+    seedBoardRandom(&game.random, game.seed);
+    printf("Seed: %llu (replay this board with --seed)\n", (unsigned long long)game.seed);
     initializeBoard(&game);
+    redrawBoard();
     initializeButtons();
     
     while (!WindowShouldClose()) {
@@ -343,6 +376,8 @@ int main() {
         EndDrawing();
     }
     
+    UnloadRenderTexture(boardTexture);
     CloseWindow();
+    freeBoard(&game.board);
     return 0;
 }
\ No newline at end of file
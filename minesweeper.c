@@ -4,17 +4,19 @@
 #include <time.h>
 #include <string.h>
 
-#define SIZE 6
-#define MINES 8
+#include "minesweeper_board.h"
+#include "minesweeper_solver.h"
 
-typedef struct {
-    int isMine;
-    int isRevealed;
-    int adjacentMines;
-} Cell;
+// Board used when no size is given on the command line
+#define DEFAULT_WIDTH 6
+#define DEFAULT_HEIGHT 6
+#define DEFAULT_MINES 8
 
 typedef struct {
-    Cell board[SIZE][SIZE];
+    Board board;
+    BoardRandom random;
+    Solver solver;
+    int minesPlaced;
     int minesRemaining;
     int cellsRevealed;
     int minesHit;
@@ -22,78 +24,49 @@ typedef struct {
 } Game;
 
 void initializeBoard(Game *game) {
-    // Initialize all cells
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            game->board[i][j].isMine = 0;
-            game->board[i][j].isRevealed = 0;
-            game->board[i][j].adjacentMines = 0;
-        }
-    }
+    Board *board = &game->board;
     
-    // Place mines randomly
-    int minesPlaced = 0;
-    srand(time(NULL));
-    while (minesPlaced < MINES) {
-        int row = rand() % SIZE;
-        int col = rand() % SIZE;
-        if (!game->board[row][col].isMine) {
-            game->board[row][col].isMine = 1;
-            minesPlaced++;
-        }
-    }
+    // Initialize all cells; mines are placed on the first reveal so that
+    // it never hits one
+    resetBoard(board);
+    resetSolver(&game->solver);
+    game->minesPlaced = 0;
     
-    // Calculate adjacent mines for each cell
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            if (!game->board[i][j].isMine) {
-                int count = 0;
-                for (int di = -1; di <= 1; di++) {
-                    for (int dj = -1; dj <= 1; dj++) {
-                        int ni = i + di;
-                        int nj = j + dj;
-                        if (ni >= 0 && ni < SIZE && nj >= 0 && nj < SIZE) {
-                            if (game->board[ni][nj].isMine) {
-                                count++;
-                            }
-                        }
-                    }
-                }
-                game->board[i][j].adjacentMines = count;
-            }
-        }
-    }
-    
-    game->minesRemaining = MINES;
+    game->minesRemaining = board->mines;
     game->cellsRevealed = 0;
     game->minesHit = 0;
     game->lives = 1;
 }
 
 void displayBoard(Game *game, int showMines) {
-    printf("\n   ");
-    for (int j = 0; j < SIZE; j++) {
-        printf("%d ", j);
+    const Board *board = &game->board;
+    // Columns and row labels are as wide as the largest index
+    int cellWidth = snprintf(NULL, 0, "%d", board->width - 1);
+    int labelWidth = snprintf(NULL, 0, "%d", board->height - 1);
+    
+    printf("\n%*s  ", labelWidth, "");
+    for (int j = 0; j < board->width; j++) {
+        printf("%*d ", cellWidth, j);
     }
-    printf("\n   ");
-    for (int j = 0; j < SIZE * 2 - 1; j++) {
+    printf("\n%*s  ", labelWidth, "");
+    for (int j = 0; j < board->width * (cellWidth + 1) - 1; j++) {
         printf("-");
     }
     printf("\n");
     
-    for (int i = 0; i < SIZE; i++) {
-        printf("%d| ", i);
-        for (int j = 0; j < SIZE; j++) {
-            if (!game->board[i][j].isRevealed) {
-                printf("? ");
-            } else if (showMines && game->board[i][j].isMine) {
-                printf("* ");
-            } else if (game->board[i][j].isMine) {
-                printf("X ");
-            } else if (game->board[i][j].adjacentMines == 0) {
-                printf("  ");
+    for (int i = 0; i < board->height; i++) {
+        printf("%*d| ", labelWidth, i);
+        for (int j = 0; j < board->width; j++) {
+            if (!boardIsRevealed(board, i, j)) {
+                printf("%*s ", cellWidth, "?");
+            } else if (showMines && boardIsMine(board, i, j)) {
+                printf("%*s ", cellWidth, "*");
+            } else if (boardIsMine(board, i, j)) {
+                printf("%*s ", cellWidth, "X");
+            } else if (boardAdjacentMines(board, i, j) == 0) {
+                printf("%*s ", cellWidth, "");
             } else {
-                printf("%d ", game->board[i][j].adjacentMines);
+                printf("%*d ", cellWidth, boardAdjacentMines(board, i, j));
             }
         }
         printf("\n");
@@ -101,24 +74,12 @@ void displayBoard(Game *game, int showMines) {
 }
 
 void floodFill(Game *game, int row, int col) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
-        return;
-    }
-    
-    if (game->board[row][col].isRevealed) {
-        return;
-    }
-    
-    game->board[row][col].isRevealed = 1;
-    game->cellsRevealed++;
-    
-    if (game->board[row][col].adjacentMines == 0) {
-        for (int di = -1; di <= 1; di++) {
-            for (int dj = -1; dj <= 1; dj++) {
-                floodFill(game, row + di, col + dj);
-            }
-        }
+    int revealed = floodReveal(&game->board, row, col);
+    if (revealed < 0) {
+        fprintf(stderr, "Error: out of memory while revealing cells\n");
+        exit(1);
     }
+    game->cellsRevealed += revealed;
 }
 
 int askCPythonQuestion() {
@@ -177,17 +138,22 @@ void displayRoastingMessage() {
 }
 
 int revealCell(Game *game, int row, int col) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
+    if (row < 0 || row >= game->board.height || col < 0 || col >= game->board.width) {
         printf("Invalid coordinates!\n");
         return 0;
     }
     
-    if (game->board[row][col].isRevealed) {
+    if (boardIsRevealed(&game->board, row, col)) {
         printf("Cell already revealed!\n");
         return 0;
     }
     
-    if (game->board[row][col].isMine) {
+    if (!game->minesPlaced) {
+        placeMines(&game->board, &game->random, row, col);
+        game->minesPlaced = 1;
+    }
+    
+    if (boardIsMine(&game->board, row, col)) {
         game->minesHit++;
         
         if (game->minesHit == 1) {
@@ -197,7 +163,9 @@ int revealCell(Game *game, int row, int col) {
             if (askCPythonQuestion()) {
                 printf("\n🎉 CORRECT! You've earned a SECOND LIFE! 🎉\n");
                 printf("Lives remaining: %d\n", ++game->lives);
+                // The defused mine is shown, but it is not a safe cell
                 floodFill(game, row, col);
+                game->cellsRevealed--;
                 return 1;
             } else {
                 printf("\nGame Over! Wrong answer!\n");
@@ -215,19 +183,57 @@ int revealCell(Game *game, int row, int col) {
     return 1;
 }
 
+// Ask the solver for the next move and print it
+void showHint(Game *game) {
+    SolverMove move;
+    
+    if (!game->minesPlaced) {
+        printf("Hint: the first cell you reveal is never a mine.\n");
+        return;
+    }
+    int found = solverNextMove(&game->solver, &game->board, &move);
+    if (found < 0) {
+        fprintf(stderr, "Error: out of memory while solving the board\n");
+        exit(1);
+    }
+    if (found == 0) {
+        printf("Hint: no hidden cell is left to try.\n");
+    } else if (move.mineChance == 0) {
+        printf("Hint: row %d, column %d is safe.\n", move.row, move.col);
+    } else {
+        printf("Hint: nothing is certain; row %d, column %d is the safest guess (%.0f%% chance of a mine).\n",
+               move.row, move.col, 100 * move.mineChance);
+    }
+}
+
 int checkWin(Game *game) {
-    return game->cellsRevealed == (SIZE * SIZE - MINES);
+    return hiddenSafeCells(&game->board) == 0;
 }
 
-void playGame() {
+int playGame(const BoardOptions *options) {
     Game game;
     int gameOver = 0;
     int won = 0;
+    int width = options->width;
+    int height = options->height;
+    
+    if (initBoard(&game.board, width, height, options->mines) != 0) {
+        fprintf(stderr, "Error: could not allocate a %dx%d board\n", width, height);
+        return 1;
+    }
+    if (initSolver(&game.solver, &game.board) != 0) {
+        fprintf(stderr, "Error: could not allocate the solver\n");
+        freeBoard(&game.board);
+        return 1;
+    }
+    seedBoardRandom(&game.random, options->seed);
     
-    printf("Welcome to Minesweeper (6x6)!\n");
-    printf("Mines: %d\n", MINES);
+    printf("Welcome to Minesweeper (%dx%d)!\n", width, height);
+    printf("Mines: %d\n", options->mines);
+    printf("Seed: %llu (replay this board with --seed)\n", (unsigned long long)options->seed);
     printf("🛡️  Starting Lives: 1 (Answer the logic question correctly to gain a second life!)\n");
-    printf("Instructions: Enter row and column (0-5) to reveal a cell\n\n");
+    printf("Instructions: Enter row (0-%d) and column (0-%d) to reveal a cell, or row -1 for a hint\n\n",
+           height - 1, width - 1);
     
     initializeBoard(&game);
     displayBoard(&game, 0);
@@ -235,10 +241,18 @@ void playGame() {
     while (!gameOver && !won) {
         int row, col;
         printf("\n[Lives: %d] ", game.lives);
-        printf("Enter row (0-5): ");
-        scanf("%d", &row);
-        printf("Enter column (0-5): ");
-        scanf("%d", &col);
+        printf("Enter row (0-%d): ", height - 1);
+        if (scanf("%d", &row) != 1) {
+            break;
+        }
+        if (row == -1) {
+            showHint(&game);
+            continue;
+        }
+        printf("Enter column (0-%d): ", width - 1);
+        if (scanf("%d", &col) != 1) {
+            break;
+        }
         
         int result = revealCell(&game, row, col);
         
@@ -256,9 +270,162 @@ void playGame() {
             }
         }
     }
+    
+    freeSolver(&game.solver);
+    freeBoard(&game.board);
+    return 0;
 }
 
-int main() {
-    playGame();
+// Reference copy of the original adjacency loop over a byte grid, kept only
+// as a benchmark baseline
+static void adjacencyBaseline(const unsigned char *mines, unsigned char *counts, int width, int height) {
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            if (!mines[(size_t)i * width + j]) {
+                int count = 0;
+                for (int di = -1; di <= 1; di++) {
+                    for (int dj = -1; dj <= 1; dj++) {
+                        int ni = i + di;
+                        int nj = j + dj;
+                        if (ni >= 0 && ni < height && nj >= 0 && nj < width) {
+                            if (mines[(size_t)ni * width + nj]) {
+                                count++;
+                            }
+                        }
+                    }
+                }
+                counts[(size_t)i * width + j] = count;
+            }
+        }
+    }
+}
+
+// Seconds elapsed since start
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Time the adjacency pass on one random board: the original loop against
+// each box-sum kernel, and the preset kernel when the board has a preset
+// shape, checking that every kernel gives the same counts
+int runBenchmark(const BoardOptions *options) {
+    static const struct {
+        const char *name;
+        BoardKernel kernel;
+    } kernels[] = {
+        {"scalar", adjacencyScalar},
+        {"vector", adjacencyVector},
+#if defined(__x86_64__) || defined(__i386__)
+        {"avx2", adjacencyAvx2},
+#endif
+    };
+    int width = options->width;
+    int height = options->height;
+    size_t cells = (size_t)width * height;
+    // Enough runs for about 200 million cells per kernel
+    int runs = cells >= 200000000 ? 1 : (int)(200000000 / cells);
+    Board board;
+    BoardRandom random;
+    struct timespec start;
+
+    if (initBoard(&board, width, height, options->mines) != 0) {
+        fprintf(stderr, "Error: could not allocate a %dx%d board\n", width, height);
+        return 1;
+    }
+    unsigned char *mines = malloc(cells);
+    unsigned char *counts = calloc(cells, 1);
+    if (mines == NULL || counts == NULL) {
+        fprintf(stderr, "Error: could not allocate the baseline grid\n");
+        free(mines);
+        free(counts);
+        freeBoard(&board);
+        return 1;
+    }
+    seedBoardRandom(&random, options->seed);
+    placeMines(&board, &random, -1, -1);
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            mines[(size_t)row * width + col] = boardIsMine(&board, row, col);
+        }
+    }
+
+    printf("Benchmark: %dx%d board, %d mines, %d runs (ns per cell)\n",
+           width, height, options->mines, runs);
+    printf("%10s %10s %10s %9s\n", "kernel", "ns/cell", "GB/s", "speedup");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int run = 0; run < runs; run++) {
+        adjacencyBaseline(mines, counts, width, height);
+    }
+    double baseline = elapsedSeconds(&start);
+    printf("%10s %10.3f %10s %9s\n", "baseline", baseline * 1e9 / runs / cells, "-", "1.00x");
+
+    // Bytes moved per pass: the mine plane read, four count slices and the
+    // zero plane written
+    double bytes = 6.0 * board.planeWords * sizeof(uint64_t);
+    int mismatches = 0;
+    size_t kernelCount = sizeof(kernels) / sizeof(kernels[0]);
+    for (size_t k = 0; k <= kernelCount; k++) {
+        const char *name = k < kernelCount ? kernels[k].name : "preset";
+        BoardKernel kernel = k < kernelCount ? kernels[k].kernel : board.adjacencyKernel;
+        if (k == kernelCount && (kernel == adjacencyScalar || kernel == adjacencyVector)) break;
+#if defined(__x86_64__) || defined(__i386__)
+        if (kernel == adjacencyAvx2 && k == kernelCount) break;
+        if (kernel == adjacencyAvx2 && !__builtin_cpu_supports("avx2")) {
+            printf("%10s %10s\n", name, "n/a");
+            continue;
+        }
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int run = 0; run < runs; run++) {
+            kernel(&board);
+        }
+        double seconds = elapsedSeconds(&start);
+        printf("%10s %10.3f %10.2f %8.2fx\n", name, seconds * 1e9 / runs / cells,
+               bytes * runs / seconds / 1e9, seconds > 0 ? baseline / seconds : 0.0);
+
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                size_t cell = (size_t)row * width + col;
+                if (!mines[cell] && boardAdjacentMines(&board, row, col) != counts[cell]) {
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    free(mines);
+    free(counts);
+    freeBoard(&board);
+    if (mismatches > 0) {
+        fprintf(stderr, "Error: %d counts differ from the baseline\n", mismatches);
+        return 1;
+    }
     return 0;
+}
+
+int main(int argc, char *argv[]) {
+    BoardOptions options = {DEFAULT_WIDTH, DEFAULT_HEIGHT, DEFAULT_MINES, 0, 0};
+    
+    // --bench times the adjacency pass on the given board instead of playing
+    int benchmark = argc > 1 && strcmp(argv[1], "--bench") == 0;
+    if (benchmark) {
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+    if (parseBoardOptions(argc, argv, &options) != 0) {
+        return 1;
+    }
+    if (!options.seeded) {
+        options.seed = defaultBoardSeed();
+    }
+    if (benchmark) {
+        return runBenchmark(&options);
+    }
+    // Only the quiz and roast picks use rand(); the board has its own generator
+    srand(time(NULL));
+    return playGame(&options);
 }
\ No newline at end of file
@@ -0,0 +1,600 @@
+#ifndef MINESWEEPER_BOARD_H
+#define MINESWEEPER_BOARD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Bitboard used by minesweeper.c and minesweepeer.c, sized at run time.
+//
+// Each plane is a flat array of 64-bit words, rowWords per row, with column c
+// at bit c + 1 of its row. Bit 0, the bits past the last column and one row
+// above and below the board are always zero, so neighbours are plain shifts
+// and word offsets and need no bounds checks. Adjacent-mine counts are
+// bit-sliced: bit k of a cell's count is in adjacent[k], so the counts of 64
+// cells are computed with a few word operations.
+
+#define BOARD_MAX_WIDTH 10000
+#define BOARD_MAX_HEIGHT 10000
+
+// Zero words kept before and after every plane, so passes that look one word
+// beyond a padding row stay in bounds; a cache line keeps planes aligned
+#define BOARD_PLANE_GUARD 8
+
+// Seeds and spans the reveal engine starts with; both buffers grow on demand
+// and are kept for the next reveal
+#define BOARD_INITIAL_SEEDS 1024
+#define BOARD_INITIAL_SPANS 1024
+
+typedef struct Board Board;
+
+// Board pass picked once per board: compiled for the board's shape when it
+// is a preset one, otherwise for the widest instruction set the CPU runs
+typedef void (*BoardKernel)(Board *board);
+
+// Cells first..last of a row, revealed by one call of floodReveal()
+typedef struct {
+    int row;
+    int first;
+    int last;
+} RevealSpan;
+
+struct Board {
+    int width;
+    int height;
+    int mines;
+    int rowWords;
+    size_t planeWords;
+    uint64_t *mine;
+    uint64_t *revealed;
+    uint64_t *flagged;
+    uint64_t *adjacent[4];
+    // Safe cells without adjacent mines, which a reveal spreads through
+    uint64_t *zero;
+    uint64_t *rowMask;
+    BoardKernel adjacencyKernel;
+    void *storage;
+    // Reveal engine: pending seeds (padded row << 16 | bit position), and
+    // the spans revealed by the last floodReveal()
+    uint32_t *seeds;
+    size_t seedCapacity;
+    RevealSpan *spans;
+    size_t spanCount;
+    size_t spanCapacity;
+    // floodReveal() calls since the last resetBoard(), so a reader that saw
+    // the count before the last call knows spans holds everything new
+    unsigned long reveals;
+};
+
+typedef struct {
+    const char *name;
+    int width;
+    int height;
+    int mines;
+} BoardPreset;
+
+static const BoardPreset boardPresets[] = {
+    {"beginner", 9, 9, 10},
+    {"intermediate", 16, 16, 40},
+    {"expert", 30, 16, 99}
+};
+
+#define BOARD_PRESET_COUNT ((int)(sizeof(boardPresets) / sizeof(boardPresets[0])))
+
+// Board size and seed chosen on the command line
+typedef struct {
+    int width;
+    int height;
+    int mines;
+    uint64_t seed;
+    int seeded;
+} BoardOptions;
+
+// xoshiro256** state; a board is a pure function of the seed and first click
+typedef struct {
+    uint64_t state[4];
+} BoardRandom;
+
+static inline BoardKernel selectAdjacencyKernel(int width, int height);
+
+static inline size_t boardWord(const Board *board, int row, int col) {
+    return (size_t)(row + 1) * (size_t)board->rowWords + (size_t)(col + 1) / 64;
+}
+
+static inline uint64_t boardBit(int col) {
+    return 1ULL << ((col + 1) & 63);
+}
+
+static inline int boardIsMine(const Board *board, int row, int col) {
+    return (board->mine[boardWord(board, row, col)] & boardBit(col)) != 0;
+}
+
+static inline int boardIsRevealed(const Board *board, int row, int col) {
+    return (board->revealed[boardWord(board, row, col)] & boardBit(col)) != 0;
+}
+
+static inline int boardIsFlagged(const Board *board, int row, int col) {
+    return (board->flagged[boardWord(board, row, col)] & boardBit(col)) != 0;
+}
+
+static inline void boardSetMine(Board *board, int row, int col) {
+    board->mine[boardWord(board, row, col)] |= boardBit(col);
+}
+
+static inline void boardToggleFlag(Board *board, int row, int col) {
+    board->flagged[boardWord(board, row, col)] ^= boardBit(col);
+}
+
+// Gather a cell's count from the four bit slices
+static inline int boardAdjacentMines(const Board *board, int row, int col) {
+    size_t word = boardWord(board, row, col);
+    uint64_t bit = boardBit(col);
+    return ((board->adjacent[0][word] & bit) != 0) |
+           ((board->adjacent[1][word] & bit) != 0) << 1 |
+           ((board->adjacent[2][word] & bit) != 0) << 2 |
+           ((board->adjacent[3][word] & bit) != 0) << 3;
+}
+
+// Allocate an empty width x height board for the given number of mines;
+// returns 0, or -1 if the size is out of range or memory ran out
+static inline int initBoard(Board *board, int width, int height, int mines) {
+    memset(board, 0, sizeof(*board));
+    if (width < 1 || width > BOARD_MAX_WIDTH || height < 1 || height > BOARD_MAX_HEIGHT ||
+        mines < 0 || mines >= width * height) {
+        return -1;
+    }
+    board->width = width;
+    board->height = height;
+    board->mines = mines;
+    board->rowWords = (width + 2 + 63) / 64;
+    board->planeWords = (size_t)(height + 2) * (size_t)board->rowWords;
+
+    // Eight guarded planes and the row mask, each starting on a cache line
+    size_t planeBytes = ((board->planeWords + 2 * BOARD_PLANE_GUARD) * sizeof(uint64_t) + 63) & ~(size_t)63;
+    size_t maskBytes = ((size_t)board->rowWords * sizeof(uint64_t) + 63) & ~(size_t)63;
+    unsigned char *storage = aligned_alloc(64, 8 * planeBytes + maskBytes);
+    board->seeds = malloc(BOARD_INITIAL_SEEDS * sizeof(uint32_t));
+    board->spans = malloc(BOARD_INITIAL_SPANS * sizeof(RevealSpan));
+    if (storage == NULL || board->seeds == NULL || board->spans == NULL) {
+        free(storage);
+        free(board->seeds);
+        free(board->spans);
+        return -1;
+    }
+    board->seedCapacity = BOARD_INITIAL_SEEDS;
+    board->spanCapacity = BOARD_INITIAL_SPANS;
+    memset(storage, 0, 8 * planeBytes + maskBytes);
+
+    uint64_t *planes[8];
+    for (int p = 0; p < 8; p++) planes[p] = (uint64_t *)(storage + p * planeBytes) + BOARD_PLANE_GUARD;
+    board->mine = planes[0];
+    board->revealed = planes[1];
+    board->flagged = planes[2];
+    for (int k = 0; k < 4; k++) board->adjacent[k] = planes[3 + k];
+    board->zero = planes[7];
+    board->rowMask = (uint64_t *)(storage + 8 * planeBytes);
+    for (int col = 0; col < width; col++) {
+        board->rowMask[(col + 1) / 64] |= boardBit(col);
+    }
+    board->adjacencyKernel = selectAdjacencyKernel(width, height);
+    board->storage = storage;
+    return 0;
+}
+
+// Clear every plane for a new game on the same board
+static inline void resetBoard(Board *board) {
+    size_t bytes = board->planeWords * sizeof(uint64_t);
+    memset(board->mine, 0, bytes);
+    memset(board->revealed, 0, bytes);
+    memset(board->flagged, 0, bytes);
+    board->spanCount = 0;
+    board->reveals = 0;
+}
+
+static inline void freeBoard(Board *board) {
+    free(board->storage);
+    free(board->seeds);
+    free(board->spans);
+    memset(board, 0, sizeof(*board));
+}
+
+// Adjacency is a separable 3x3 box sum on the mine plane. The vertical pass
+// adds each cell's column of three (two at the centre, which is not its own
+// neighbour) into 2-bit slices; the horizontal pass adds the left and right
+// column sums, shifted in from the neighbouring bits and words, to the
+// centre one. Padding bits and rows are zero, so the same word operations
+// apply everywhere and the only work per word is a handful of loads, shifts
+// and logic ops: large boards are bound by memory bandwidth, not branches.
+//
+// BOARD_BOX_SUM_STEP defines the step for one word or for a vector of words
+// (GCC vector extensions, which become SSE2 or AVX2 instructions), so the
+// scalar and vector paths cannot drift apart.
+#define BOARD_LANES 4
+
+typedef uint64_t BoardLanes __attribute__((vector_size(BOARD_LANES * sizeof(uint64_t))));
+
+#define BOARD_BOX_SUM_STEP(name, Word)                                              \
+static inline __attribute__((always_inline))                                        \
+void name(Board *board, size_t i, int w, size_t rowWords) {                         \
+    const uint64_t *mine = board->mine;                                             \
+    Word up[3], centre[3], down[3], mask;                                           \
+    /* Columns of the words before, at and after i; loads may be unaligned */      \
+    for (int n = 0; n < 3; n++) {                                                   \
+        memcpy(&up[n], mine + i - rowWords + n - 1, sizeof(Word));                  \
+        memcpy(&centre[n], mine + i + n - 1, sizeof(Word));                         \
+        memcpy(&down[n], mine + i + rowWords + n - 1, sizeof(Word));                \
+    }                                                                               \
+    memcpy(&mask, board->rowMask + w, sizeof(Word));                                \
+    /* Vertical pass: full columns beside the cell, top and bottom at it */        \
+    Word side0[3], side1[3];                                                        \
+    for (int n = 0; n < 3; n += 2) {                                                \
+        side0[n] = up[n] ^ centre[n] ^ down[n];                                     \
+        side1[n] = (up[n] & centre[n]) | (down[n] & (up[n] ^ centre[n]));           \
+    }                                                                               \
+    Word column0 = up[1] ^ centre[1] ^ down[1];                                     \
+    Word column1 = (up[1] & centre[1]) | (down[1] & (up[1] ^ centre[1]));           \
+    Word left0 = column0 << 1 | side0[0] >> 63;                                     \
+    Word left1 = column1 << 1 | side1[0] >> 63;                                     \
+    Word right0 = column0 >> 1 | side0[2] << 63;                                    \
+    Word right1 = column1 >> 1 | side1[2] << 63;                                    \
+    Word middle0 = up[1] ^ down[1];                                                 \
+    Word middle1 = up[1] & down[1];                                                 \
+    /* Horizontal pass: add the three 2-bit sums into four bit slices */           \
+    Word sum0 = left0 ^ right0 ^ middle0;                                           \
+    Word carry = (left0 & right0) | (middle0 & (left0 ^ right0));                   \
+    Word twos = left1 ^ right1 ^ middle1;                                           \
+    Word fours = (left1 & right1) | (middle1 & (left1 ^ right1));                   \
+    Word sum1 = twos ^ carry;                                                       \
+    Word fours2 = twos & carry;                                                     \
+    Word sum2 = fours ^ fours2;                                                     \
+    Word sum3 = fours & fours2;                                                     \
+    Word out[5] = {sum0 & mask, sum1 & mask, sum2 & mask, sum3 & mask,              \
+                   ~(centre[1] | sum0 | sum1 | sum2 | sum3) & mask};                \
+    for (int k = 0; k < 4; k++) memcpy(board->adjacent[k] + i, &out[k], sizeof(Word)); \
+    memcpy(board->zero + i, &out[4], sizeof(Word));                                 \
+}
+
+BOARD_BOX_SUM_STEP(boxSumWord, uint64_t)
+BOARD_BOX_SUM_STEP(boxSumLanes, BoardLanes)
+
+// Run the box sum over every row, lanes words at a time while they fit.
+// Always inlined, so each kernel below compiles it for its own target, and
+// a kernel passing a constant shape gets the row loops fully unrolled.
+static inline __attribute__((always_inline))
+void adjacencyBoxSum(Board *board, int lanes, int rowWords, int height) {
+    for (int r = 1; r <= height; r++) {
+        size_t row = (size_t)r * rowWords;
+        int w = 0;
+        if (lanes > 1) {
+            for (; w + BOARD_LANES <= rowWords; w += BOARD_LANES) boxSumLanes(board, row + w, w, rowWords);
+        }
+        for (; w < rowWords; w++) boxSumWord(board, row + w, w, rowWords);
+    }
+}
+
+// Scalar fallback, and the baseline the vector kernels are checked against
+static inline void adjacencyScalar(Board *board) { adjacencyBoxSum(board, 1, board->rowWords, board->height); }
+// Four words per step; on x86-64 without AVX2 each step is two SSE2 operations
+static inline void adjacencyVector(Board *board) {
+    adjacencyBoxSum(board, BOARD_LANES, board->rowWords, board->height);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static inline void adjacencyAvx2(Board *board) { adjacencyBoxSum(board, BOARD_LANES, board->rowWords, board->height); }
+#endif
+
+// The preset shapes: every preset row fits one word, and beginner is 9
+// rows high while intermediate and expert are 16
+static inline void adjacencyOneWord9(Board *board) { adjacencyBoxSum(board, 1, 1, 9); }
+static inline void adjacencyOneWord16(Board *board) { adjacencyBoxSum(board, 1, 1, 16); }
+
+// Pick the kernel compiled for the board's shape if it is a preset one,
+// otherwise the widest kernel the CPU runs
+static inline BoardKernel selectAdjacencyKernel(int width, int height) {
+    if (width + 2 <= 64 && height == 9) return adjacencyOneWord9;
+    if (width + 2 <= 64 && height == 16) return adjacencyOneWord16;
+    // One or two words per row leave nothing for the vector step
+    if (width + 2 <= 2 * 64 || height < 1) return adjacencyScalar;
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) return adjacencyAvx2;
+#endif
+    return adjacencyVector;
+}
+
+// Count the mines around every cell
+static inline void computeAdjacency(Board *board) {
+    board->adjacencyKernel(board);
+}
+
+// Make room for count more elements in a buffer that grows by doubling
+static inline int reserveBuffer(void **buffer, size_t *capacity, size_t used, size_t count, size_t size) {
+    if (used + count <= *capacity) return 0;
+    size_t grown = *capacity * 2;
+    while (grown < used + count) grown *= 2;
+    void *larger = realloc(*buffer, grown * size);
+    if (larger == NULL) return -1;
+    *buffer = larger;
+    *capacity = grown;
+    return 0;
+}
+
+// Bits of positions first..last (inclusive) that fall in word w of a row
+static inline uint64_t rangeInWord(int w, int first, int last) {
+    int low = first - w * 64;
+    int high = last - w * 64;
+    uint64_t mask = ~0ULL;
+    if (low > 0) mask &= ~0ULL << low;
+    if (high < 63) mask &= ~(~0ULL << (high + 1));
+    return mask;
+}
+
+// Cells a reveal may spread through: no adjacent mines and not yet revealed
+static inline uint64_t fillableWord(const Board *board, size_t i) {
+    return board->zero[i] & ~board->revealed[i];
+}
+
+// Reveal the bits of reveal in word w of padded row r, recording them as
+// spans (merged with the previous span when they continue it)
+static inline int revealBits(Board *board, int r, int w, uint64_t reveal) {
+    board->revealed[(size_t)r * board->rowWords + w] |= reveal;
+    while (reveal) {
+        int start = __builtin_ctzll(reveal);
+        uint64_t rest = ~(reveal >> start);
+        int length = rest ? __builtin_ctzll(rest) : 64 - start;
+        int first = w * 64 + start - 1;
+        int last = first + length - 1;
+        RevealSpan *previous = board->spanCount ? &board->spans[board->spanCount - 1] : NULL;
+        if (previous && previous->row == r - 1 && previous->last + 1 == first) {
+            previous->last = last;
+        } else {
+            if (reserveBuffer((void **)&board->spans, &board->spanCapacity, board->spanCount, 1,
+                              sizeof(RevealSpan)) != 0) {
+                return -1;
+            }
+            board->spans[board->spanCount++] = (RevealSpan){r - 1, first, last};
+        }
+        reveal = start + length == 64 ? 0 : reveal & (~0ULL << (start + length));
+    }
+    return 0;
+}
+
+// Reveal (row, col) and, if it has no adjacent mines, the connected region
+// of such cells with its border. Iterative scanline fill: a seed is widened
+// to the whole run of fillable cells in its row, which is revealed with its
+// two end cells; the rows above and below reveal their numbered cells over
+// the same range and queue one seed per fillable run. Fillable cells only
+// become revealed when their run is taken, so the revealed plane doubles as
+// the visited set and the work is linear in the cells revealed.
+//
+// Returns the number of cells newly revealed, which board->spans lists, or
+// -1 if the work buffers could not grow.
+static inline int floodReveal(Board *board, int row, int col) {
+    int rowWords = board->rowWords;
+    size_t seedCount = 0;
+    board->spanCount = 0;
+    board->reveals++;
+    if (boardIsRevealed(board, row, col)) return 0;
+    if (!(board->zero[boardWord(board, row, col)] & boardBit(col))) {
+        if (revealBits(board, row + 1, (col + 1) / 64, boardBit(col)) != 0) return -1;
+        return 1;
+    }
+    board->seeds[seedCount++] = (uint32_t)(row + 1) << 16 | (uint32_t)(col + 1);
+
+    while (seedCount > 0) {
+        uint32_t seed = board->seeds[--seedCount];
+        int r = (int)(seed >> 16);
+        int p = (int)(seed & 0xFFFF);
+        const size_t rowStart = (size_t)r * rowWords;
+        if (!(fillableWord(board, rowStart + p / 64) & 1ULL << (p & 63))) continue;
+
+        // Widen to the run of fillable bits around p; the padding bits at
+        // both ends of the row are never fillable, so this stops in the row
+        int w = p / 64;
+        uint64_t gaps = ~fillableWord(board, rowStart + w) & (~0ULL >> (63 - (p & 63)));
+        while (gaps == 0) {
+            gaps = ~fillableWord(board, rowStart + --w);
+        }
+        int left = w * 64 + 63 - __builtin_clzll(gaps) + 1;
+        w = p / 64;
+        gaps = ~fillableWord(board, rowStart + w) & (~0ULL << (p & 63));
+        while (gaps == 0) {
+            gaps = ~fillableWord(board, rowStart + ++w);
+        }
+        int right = w * 64 + __builtin_ctzll(gaps) - 1;
+
+        // The run and its end cells, then the three cells deep band around it
+        for (int dr = -1; dr <= 1; dr++) {
+            int nr = r + dr;
+            if (nr < 1 || nr > board->height) continue;
+            size_t start = (size_t)nr * rowWords;
+            for (w = (left - 1) / 64; w <= (right + 1) / 64; w++) {
+                uint64_t fresh = rangeInWord(w, left - 1, right + 1) & board->rowMask[w] &
+                                 ~board->revealed[start + w];
+                uint64_t fill = fresh & board->zero[start + w];
+                if (dr == 0) {
+                    if (revealBits(board, nr, w, fresh) != 0) return -1;
+                    continue;
+                }
+                if (revealBits(board, nr, w, fresh & ~fill) != 0) return -1;
+                // One seed at the start of each fillable run
+                uint64_t starts = fill & ~(fill << 1);
+                size_t needed = (size_t)__builtin_popcountll(starts);
+                if (reserveBuffer((void **)&board->seeds, &board->seedCapacity, seedCount, needed,
+                                  sizeof(uint32_t)) != 0) {
+                    return -1;
+                }
+                while (starts) {
+                    int bit = __builtin_ctzll(starts);
+                    board->seeds[seedCount++] = (uint32_t)nr << 16 | (uint32_t)(w * 64 + bit);
+                    starts &= starts - 1;
+                }
+            }
+        }
+    }
+
+    int count = 0;
+    for (size_t s = 0; s < board->spanCount; s++) {
+        count += board->spans[s].last - board->spans[s].first + 1;
+    }
+    return count;
+}
+
+// Safe cells still hidden; the game is won when this reaches zero
+static inline int hiddenSafeCells(const Board *board) {
+    int rowWords = board->rowWords;
+    int hidden = 0;
+    for (size_t i = (size_t)rowWords; i < (size_t)(board->height + 1) * rowWords; i++) {
+        hidden += __builtin_popcountll(~(board->mine[i] | board->revealed[i]) & board->rowMask[i % rowWords]);
+    }
+    return hidden;
+}
+
+// Expand a 64-bit seed into the generator state with splitmix64
+static inline void seedBoardRandom(BoardRandom *random, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        random->state[i] = z ^ (z >> 31);
+    }
+}
+
+static inline uint64_t nextBoardRandom(BoardRandom *random) {
+    uint64_t *s = random->state;
+    uint64_t result = ((s[1] * 5) << 7 | (s[1] * 5) >> 57) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = s[3] << 45 | s[3] >> 19;
+    return result;
+}
+
+// Uniform value below bound: the high half of a 128-bit product, redrawing
+// the few low halves that would make some values more likely
+static inline uint64_t boardRandomBelow(BoardRandom *random, uint64_t bound) {
+    unsigned __int128 product = (unsigned __int128)nextBoardRandom(random) * bound;
+    if ((uint64_t)product < bound) {
+        uint64_t threshold = -bound % bound;
+        while ((uint64_t)product < threshold) {
+            product = (unsigned __int128)nextBoardRandom(random) * bound;
+        }
+    }
+    return (uint64_t)(product >> 64);
+}
+
+// Seed for games started without --seed: the time mixed with a stack
+// address, which address space randomization changes between runs
+static inline uint64_t defaultBoardSeed(void) {
+    int local;
+    return (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)&local << 16;
+}
+
+// Place board->mines mines on a freshly reset board with Floyd's algorithm:
+// one draw per mine over the flat index of the allowed cells, so the cost
+// does not grow with density. (safeRow, safeCol) never gets a mine, nor do
+// its neighbours when enough cells remain; safeRow -1 allows every cell.
+// The adjacency counts are computed afterwards.
+static inline void placeMines(Board *board, BoardRandom *random, int safeRow, int safeCol) {
+    int cells = board->width * board->height;
+    int excluded[9];
+    int excludedCount = 0;
+    if (safeRow >= 0) {
+        // Row-major order keeps the excluded indices sorted
+        for (int r = safeRow - 1; r <= safeRow + 1; r++) {
+            for (int c = safeCol - 1; c <= safeCol + 1; c++) {
+                if (r >= 0 && r < board->height && c >= 0 && c < board->width) {
+                    excluded[excludedCount++] = r * board->width + c;
+                }
+            }
+        }
+        if (cells - excludedCount < board->mines) {
+            excluded[0] = safeRow * board->width + safeCol;
+            excludedCount = 1;
+        }
+    }
+
+    int allowed = cells - excludedCount;
+    for (int j = allowed - board->mines; j < allowed; j++) {
+        // Floyd: draw from [0, j]; if that cell is taken, j itself is not
+        int pick[2] = {(int)boardRandomBelow(random, (uint64_t)j + 1), j};
+        for (int choice = 0; choice < 2; choice++) {
+            int cell = pick[choice];
+            for (int e = 0; e < excludedCount; e++) {
+                if (excluded[e] <= cell) cell++;
+            }
+            int row = cell / board->width;
+            int col = cell % board->width;
+            if (!boardIsMine(board, row, col)) {
+                boardSetMine(board, row, col);
+                break;
+            }
+        }
+    }
+    computeAdjacency(board);
+}
+
+// Read [--seed N] [beginner|intermediate|expert | WIDTH HEIGHT MINES] from
+// the command line; options not given keep their values. Returns 0, or -1
+// after printing the usage.
+static inline int parseBoardOptions(int argc, char *argv[], BoardOptions *options) {
+    char *sizeArgs[3];
+    int sizeCount = 0;
+    int valid = 1;
+    for (int i = 1; i < argc && valid; i++) {
+        if (strcmp(argv[i], "--seed") == 0) {
+            char *end;
+            if (i + 1 >= argc || argv[i + 1][0] == '-') {
+                valid = 0;
+                break;
+            }
+            options->seed = strtoull(argv[++i], &end, 10);
+            options->seeded = 1;
+            valid = *end == '\0';
+        } else if (sizeCount < 3) {
+            sizeArgs[sizeCount++] = argv[i];
+        } else {
+            valid = 0;
+        }
+    }
+
+    if (valid && sizeCount == 1) {
+        valid = 0;
+        for (int p = 0; p < BOARD_PRESET_COUNT; p++) {
+            if (strcmp(sizeArgs[0], boardPresets[p].name) == 0) {
+                options->width = boardPresets[p].width;
+                options->height = boardPresets[p].height;
+                options->mines = boardPresets[p].mines;
+                valid = 1;
+            }
+        }
+    } else if (valid && sizeCount == 3) {
+        char *end[3];
+        long w = strtol(sizeArgs[0], &end[0], 10);
+        long h = strtol(sizeArgs[1], &end[1], 10);
+        long m = strtol(sizeArgs[2], &end[2], 10);
+        valid = *end[0] == '\0' && *end[1] == '\0' && *end[2] == '\0' &&
+                w >= 1 && w <= BOARD_MAX_WIDTH && h >= 1 && h <= BOARD_MAX_HEIGHT && m >= 0 && m < w * h;
+        if (valid) {
+            options->width = (int)w;
+            options->height = (int)h;
+            options->mines = (int)m;
+        }
+    } else if (sizeCount != 0) {
+        valid = 0;
+    }
+    if (valid) return 0;
+
+    fprintf(stderr, "Usage: %s [--seed N] [beginner|intermediate|expert | WIDTH HEIGHT MINES]\n", argv[0]);
+    fprintf(stderr, "  Boards are 1-%d x 1-%d cells with fewer mines than cells.\n",
+            BOARD_MAX_WIDTH, BOARD_MAX_HEIGHT);
+    fprintf(stderr, "  The same seed and first click always give the same board.\n");
+    return -1;
+}
+
+#endif
@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "minesweeper_board.h"
+#include "minesweeper_solver.h"
+
+// Headless simulator: the solver plays every board size and mine density
+// on a pool of threads, and the results are reported per combination.
+
+#define SIM_MAX_SIZES 16
+#define SIM_MAX_DENSITIES 16
+#define SIM_DEFAULT_GAMES 100000
+// Games a worker takes from the shared counter at a time
+#define SIM_CHUNK 64
+
+typedef struct {
+    int width;
+    int height;
+} SimSize;
+
+typedef struct {
+    SimSize sizes[SIM_MAX_SIZES];
+    int sizeCount;
+    double densities[SIM_MAX_DENSITIES];
+    int densityCount;
+    unsigned long long games;
+    int threads;
+    uint64_t seed;
+    int seeded;
+} SimOptions;
+
+typedef struct {
+    unsigned long long games;
+    unsigned long long wins;
+    unsigned long long guesses;
+    unsigned long long moves;
+    unsigned long long reveals;
+} SimResult;
+
+typedef struct {
+    int width;
+    int height;
+    int mines;
+    unsigned long long games;
+    // Game g is played from seed + g, so results do not depend on threads
+    uint64_t seed;
+    unsigned long long nextGame;
+} SimConfig;
+
+typedef struct {
+    SimConfig *config;
+    SimResult result;
+    int failed;
+} SimWorker;
+
+// Seconds elapsed since start
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Play one game on the worker's board with the solver; mines are placed
+// around its first move. Returns 1 for a win, 0 for a loss, -1 if memory
+// ran out.
+static int playSimGame(Board *board, Solver *solver, uint64_t seed, SimResult *result) {
+    BoardRandom random;
+    SolverMove move;
+    int hidden = board->width * board->height - board->mines;
+    int placed = 0;
+
+    seedBoardRandom(&random, seed);
+    resetBoard(board);
+    resetSolver(solver);
+    result->games++;
+    while (hidden > 0) {
+        int found = solverNextMove(solver, board, &move);
+        if (found <= 0) return found;
+        if (!placed) {
+            placeMines(board, &random, move.row, move.col);
+            placed = 1;
+        } else if (move.mineChance > 0) {
+            result->guesses++;
+        }
+        result->moves++;
+        if (boardIsMine(board, move.row, move.col)) return 0;
+        int revealed = floodReveal(board, move.row, move.col);
+        if (revealed < 0) return -1;
+        result->reveals += revealed;
+        hidden -= revealed;
+    }
+    result->wins++;
+    return 1;
+}
+
+// Play chunks of games until the configuration has none left. The board
+// and solver are allocated once and reused for every game.
+static void *simWorker(void *arg) {
+    SimWorker *worker = arg;
+    SimConfig *config = worker->config;
+    Board board;
+    Solver solver;
+
+    if (initBoard(&board, config->width, config->height, config->mines) != 0) {
+        worker->failed = 1;
+        return NULL;
+    }
+    if (initSolver(&solver, &board) != 0) {
+        freeBoard(&board);
+        worker->failed = 1;
+        return NULL;
+    }
+    for (;;) {
+        unsigned long long first = __atomic_fetch_add(&config->nextGame, SIM_CHUNK, __ATOMIC_RELAXED);
+        if (first >= config->games) break;
+        unsigned long long last = first + SIM_CHUNK < config->games ? first + SIM_CHUNK : config->games;
+        for (unsigned long long g = first; g < last && !worker->failed; g++) {
+            if (playSimGame(&board, &solver, config->seed + g, &worker->result) < 0) {
+                worker->failed = 1;
+            }
+        }
+        if (worker->failed) break;
+    }
+    freeSolver(&solver);
+    freeBoard(&board);
+    return NULL;
+}
+
+// Play every game of one configuration on the thread pool and sum the
+// workers' results; returns 0, or -1 if a worker ran out of memory
+static int runSimConfig(SimConfig *config, int threads, SimResult *total, double *seconds) {
+    pthread_t ids[threads];
+    SimWorker workers[threads];
+    struct timespec start;
+    int started = 0;
+    int failed = 0;
+
+    memset(total, 0, sizeof(*total));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (; started < threads; started++) {
+        workers[started] = (SimWorker){config, {0, 0, 0, 0, 0}, 0};
+        if (pthread_create(&ids[started], NULL, simWorker, &workers[started]) != 0) break;
+    }
+    if (started == 0) {
+        workers[0] = (SimWorker){config, {0, 0, 0, 0, 0}, 0};
+        simWorker(&workers[0]);
+        started = 1;
+    } else {
+        for (int t = 0; t < started; t++) pthread_join(ids[t], NULL);
+    }
+    *seconds = elapsedSeconds(&start);
+
+    for (int t = 0; t < started; t++) {
+        failed |= workers[t].failed;
+        total->games += workers[t].result.games;
+        total->wins += workers[t].result.wins;
+        total->guesses += workers[t].result.guesses;
+        total->moves += workers[t].result.moves;
+        total->reveals += workers[t].result.reveals;
+    }
+    return failed ? -1 : 0;
+}
+
+// Parse a non-negative decimal number, rejecting trailing garbage
+static int parseNumber(const char *text, unsigned long long *value) {
+    char *end;
+    if (text == NULL || *text == '\0' || *text == '-') return -1;
+    errno = 0;
+    *value = strtoull(text, &end, 10);
+    return (errno != 0 || *end != '\0') ? -1 : 0;
+}
+
+// Parse a board size: WIDTHxHEIGHT or the name of a preset
+static int parseSize(const char *text, SimSize *size) {
+    char extra;
+    if (text == NULL) return -1;
+    for (int p = 0; p < BOARD_PRESET_COUNT; p++) {
+        if (strcmp(text, boardPresets[p].name) == 0) {
+            size->width = boardPresets[p].width;
+            size->height = boardPresets[p].height;
+            return 0;
+        }
+    }
+    if (sscanf(text, "%dx%d%c", &size->width, &size->height, &extra) != 2) return -1;
+    if (size->width < 1 || size->width > BOARD_MAX_WIDTH || size->height < 1 ||
+        size->height > BOARD_MAX_HEIGHT || size->width * size->height < 2) {
+        return -1;
+    }
+    return 0;
+}
+
+static void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --games N        Games per board size and density (default: %d)\n", SIM_DEFAULT_GAMES);
+    fprintf(stderr, "  --size S         Board size, WIDTHxHEIGHT or beginner|intermediate|expert;\n");
+    fprintf(stderr, "                   repeat for more (default: the three presets)\n");
+    fprintf(stderr, "  --density D      Fraction of cells that are mines, 0 to 1; repeat for more\n");
+    fprintf(stderr, "                   (default: 0.12, 0.16 and 0.20)\n");
+    fprintf(stderr, "  --threads N      Worker threads (default: all CPUs)\n");
+    fprintf(stderr, "  --seed N         Seed of the first game; the same seed replays the same games\n");
+}
+
+static int parseSimOptions(int argc, char *argv[], SimOptions *options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        unsigned long long number;
+
+        if (strcmp(arg, "--games") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1) {
+                fprintf(stderr, "Error: --games expects a positive number\n");
+                return -1;
+            }
+            options->games = number;
+            i++;
+        } else if (strcmp(arg, "--size") == 0) {
+            if (options->sizeCount == SIM_MAX_SIZES ||
+                parseSize(value, &options->sizes[options->sizeCount]) != 0) {
+                fprintf(stderr, "Error: --size expects WIDTHxHEIGHT up to %dx%d or a preset, at most %d times\n",
+                        BOARD_MAX_WIDTH, BOARD_MAX_HEIGHT, SIM_MAX_SIZES);
+                return -1;
+            }
+            options->sizeCount++;
+            i++;
+        } else if (strcmp(arg, "--density") == 0) {
+            char *end;
+            double density = value ? strtod(value, &end) : 0;
+            if (value == NULL || *end != '\0' || !(density > 0 && density < 1) ||
+                options->densityCount == SIM_MAX_DENSITIES) {
+                fprintf(stderr, "Error: --density expects a number between 0 and 1, at most %d times\n",
+                        SIM_MAX_DENSITIES);
+                return -1;
+            }
+            options->densities[options->densityCount++] = density;
+            i++;
+        } else if (strcmp(arg, "--threads") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number > 1024) {
+                fprintf(stderr, "Error: --threads expects a number between 1 and 1024\n");
+                return -1;
+            }
+            options->threads = (int)number;
+            i++;
+        } else if (strcmp(arg, "--seed") == 0) {
+            if (parseNumber(value, &number) != 0) {
+                fprintf(stderr, "Error: --seed expects a number\n");
+                return -1;
+            }
+            options->seed = number;
+            options->seeded = 1;
+            i++;
+        } else {
+            fprintf(stderr, "Error: unknown option %s\n", arg);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    SimOptions options = {
+        .games = SIM_DEFAULT_GAMES,
+        .threads = 1
+    };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 1) {
+        options.threads = cpus > 1024 ? 1024 : (int)cpus;
+    }
+    if (parseSimOptions(argc, argv, &options) != 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.sizeCount == 0) {
+        for (int p = 0; p < BOARD_PRESET_COUNT; p++) {
+            options.sizes[options.sizeCount++] = (SimSize){boardPresets[p].width, boardPresets[p].height};
+        }
+    }
+    if (options.densityCount == 0) {
+        options.densities[options.densityCount++] = 0.12;
+        options.densities[options.densityCount++] = 0.16;
+        options.densities[options.densityCount++] = 0.20;
+    }
+    if (!options.seeded) {
+        options.seed = defaultBoardSeed();
+    }
+
+    printf("Simulation: %llu games per board, %d threads, seed %llu\n", options.games, options.threads,
+           (unsigned long long)options.seed);
+    printf("%11s %7s %8s %10s %8s %13s %14s %11s\n", "board", "mines", "density", "games", "win%",
+           "guesses/game", "reveals/s", "games/s");
+
+    SimResult all = {0, 0, 0, 0, 0};
+    double allSeconds = 0;
+    int index = 0;
+    for (int s = 0; s < options.sizeCount; s++) {
+        for (int d = 0; d < options.densityCount; d++, index++) {
+            int cells = options.sizes[s].width * options.sizes[s].height;
+            int mines = (int)(options.densities[d] * cells + 0.5);
+            if (mines < 1) mines = 1;
+            if (mines > cells - 1) mines = cells - 1;
+            SimConfig config = {options.sizes[s].width, options.sizes[s].height, mines, options.games,
+                                options.seed + ((uint64_t)index << 40), 0};
+            SimResult result;
+            double seconds;
+
+            if (runSimConfig(&config, options.threads, &result, &seconds) != 0) {
+                fprintf(stderr, "Error: could not allocate a %dx%d board and solver\n",
+                        config.width, config.height);
+                return 1;
+            }
+            char board[24];
+            snprintf(board, sizeof(board), "%dx%d", config.width, config.height);
+            printf("%11s %7d %8.3f %10llu %8.2f %13.2f %14.0f %11.0f\n", board, mines, (double)mines / cells,
+                   result.games, 100.0 * result.wins / result.games, (double)result.guesses / result.games,
+                   result.reveals / seconds, result.games / seconds);
+            all.games += result.games;
+            all.wins += result.wins;
+            all.guesses += result.guesses;
+            all.reveals += result.reveals;
+            allSeconds += seconds;
+        }
+    }
+    printf("Total: %llu games in %.2f s, %.0f games per minute\n", all.games, allSeconds,
+           all.games / allSeconds * 60);
+    return 0;
+}
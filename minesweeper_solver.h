@@ -0,0 +1,1113 @@
+#ifndef MINESWEEPER_SOLVER_H
+#define MINESWEEPER_SOLVER_H
+
+#include "minesweeper_board.h"
+
+// Solver for the boards of minesweeper_board.h. It only uses what a player
+// sees: revealed cells, their counts and the number of mines.
+//
+// Each call first takes in the cells revealed since the last one (just the
+// spans of the board's last reveal when it made the only one), then:
+//  1. Single-cell rules on the numbered cells whose neighbourhood changed: a
+//     count already met by known mines makes the other hidden neighbours
+//     safe, and a count equal to the hidden neighbours makes them all mines.
+//  2. Pairwise rules against the numbered cells up to two away: when the
+//     difference of two counts needs every cell that only one of them sees to
+//     be a mine, those are mines and the cells only the other sees are safe.
+//     A subset with equal counts is the common case.
+//  3. Only when no safe cell is known, the frontier (unknown cells next to a
+//     number) is split into independent components. Every mine layout of a
+//     component is counted by backtracking, and the layouts are weighed by
+//     the ways to place the remaining mines off the frontier. A component's
+//     layout counts depend only on its cells and counts, so components left
+//     unchanged by a move come from a cache instead of being enumerated again.
+//
+// Known mines and safe cells are kept in the solver's own planes, laid out
+// like the board's; the board's flags are left to the player. Unknown cells
+// and open numbered cells are also kept as lists, so no step of a move
+// scans the whole board.
+
+// Components larger than this, or needing more search nodes, get a local
+// estimate instead of exact layout counts
+#define SOLVER_MAX_COMPONENT 48
+#define SOLVER_MAX_NODES (1L << 20)
+// Above this many frontier cells the components are weighed independently
+// at the average density instead of by exact convolution
+#define SOLVER_EXACT_FRONTIER 256
+// Cached component results: slots of the hash table and doubles of storage
+#define SOLVER_CACHE_SLOTS 4096
+#define SOLVER_CACHE_VALUES (1 << 18)
+
+// A cell to reveal and its chance of holding a mine: 0 when it was deduced
+// safe, otherwise the move is a guess
+typedef struct {
+    int row;
+    int col;
+    double mineChance;
+} SolverMove;
+
+// A numbered cell with its unknown neighbours (bit n of vars is neighbour n
+// in solverNeighbours order), their variables and the mines still missing
+typedef struct {
+    uint32_t cell;
+    int remaining;
+    int vars;
+    int count;
+    int var[8];
+} SolverConstraint;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t keyOffset;
+    uint32_t keyLength;
+    uint32_t valueOffset;
+    // Variables of the component, or -1 for an empty slot
+    int vars;
+    int exact;
+} SolverCacheEntry;
+
+typedef struct {
+    int width;
+    int height;
+    int rowWords;
+    size_t planeWords;
+    // Revealed cells already taken in, cells known to be mines or safe, and
+    // numbered cells that still have unknown neighbours
+    uint64_t *seen;
+    uint64_t *mine;
+    uint64_t *safe;
+    uint64_t *open;
+    // Numbered cells waiting on the worklist
+    uint64_t *queued;
+    void *storage;
+    int knownMines;
+    // Board reveals taken in; the first update after a reset scans it all
+    unsigned long boardReveals;
+    int rescan;
+
+    // Cells neither seen nor known, in no particular order; unknownSlot is
+    // each listed cell's place, so one is removed by moving the last there
+    uint32_t *unknownCells;
+    uint32_t *unknownSlot;
+    size_t unknownCount;
+    // Cells set in open, plus ones closed since the last frontier, which
+    // drops them. A numbered cell is closed for good once its unknowns are
+    // decided, so it is listed at most once.
+    uint32_t *openCells;
+    size_t openCount;
+    size_t openCapacity;
+
+    // Numbered cells to re-examine, and deduced safe cells to hand out; both
+    // hold cells as row * width + col
+    uint32_t *work;
+    size_t workCount;
+    size_t workCapacity;
+    uint32_t *safeQueue;
+    size_t safeCount;
+    size_t safeCapacity;
+
+    // Frontier of the last enumeration. Cells map to variables through an
+    // open-addressing table; a component is a run of componentVars and one of
+    // componentConstraints (varLocal is a variable's place in its run), and
+    // its layout counts, or for one too large to count the estimated mine
+    // chance of each variable, start at values + componentValues.
+    SolverConstraint *constraints;
+    size_t constraintCount;
+    size_t constraintCapacity;
+    uint32_t *varCells;
+    int *varParent;
+    int *varComponent;
+    int *varLocal;
+    double *probability;
+    size_t varCount;
+    size_t varCapacity;
+    int *varTable;
+    size_t varTableSize;
+    int *componentVars;
+    int *componentConstraints;
+    int *componentStart;
+    int *componentConstraintStart;
+    size_t *componentValues;
+    int *componentExact;
+    size_t componentCount;
+    double *values;
+    size_t valueCount;
+    size_t valueCapacity;
+
+    SolverCacheEntry cache[SOLVER_CACHE_SLOTS];
+    uint32_t *cacheKeys;
+    size_t cacheKeyCount;
+    size_t cacheKeyCapacity;
+    double *cacheValues;
+    size_t cacheValueCount;
+    size_t cacheEntries;
+    unsigned long cacheHits;
+    unsigned long cacheMisses;
+} Solver;
+
+// Neighbour offsets, in the order of SolverConstraint.vars
+static const int solverNeighbours[8][2] = {
+    {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}
+};
+
+static inline size_t solverWord(const Solver *solver, int row, int col) {
+    return (size_t)(row + 1) * (size_t)solver->rowWords + (size_t)(col + 1) / 64;
+}
+
+static inline int solverTest(const uint64_t *plane, const Solver *solver, int row, int col) {
+    return (plane[solverWord(solver, row, col)] & boardBit(col)) != 0;
+}
+
+static inline void solverSet(uint64_t *plane, const Solver *solver, int row, int col) {
+    plane[solverWord(solver, row, col)] |= boardBit(col);
+}
+
+static inline void solverClear(uint64_t *plane, const Solver *solver, int row, int col) {
+    plane[solverWord(solver, row, col)] &= ~boardBit(col);
+}
+
+static inline void clearSolverCache(Solver *solver) {
+    for (int i = 0; i < SOLVER_CACHE_SLOTS; i++) solver->cache[i].vars = -1;
+    solver->cacheKeyCount = 0;
+    solver->cacheValueCount = 0;
+    solver->cacheEntries = 0;
+}
+
+// Forget everything known about the last game on the same board. Cached
+// component counts stay valid: they only depend on cell positions and counts.
+static inline void resetSolver(Solver *solver) {
+    memset(solver->seen, 0, 5 * solver->planeWords * sizeof(uint64_t));
+    solver->knownMines = 0;
+    solver->workCount = 0;
+    solver->safeCount = 0;
+    solver->rescan = 1;
+    solver->unknownCount = (size_t)solver->width * (size_t)solver->height;
+    for (uint32_t cell = 0; cell < (uint32_t)solver->unknownCount; cell++) {
+        solver->unknownCells[cell] = cell;
+        solver->unknownSlot[cell] = cell;
+    }
+    solver->openCount = 0;
+}
+
+// Allocate a solver for boards of the given board's size; returns 0, or -1
+// if memory ran out
+static inline int initSolver(Solver *solver, const Board *board) {
+    memset(solver, 0, sizeof(*solver));
+    solver->width = board->width;
+    solver->height = board->height;
+    solver->rowWords = board->rowWords;
+    solver->planeWords = board->planeWords;
+    solver->storage = calloc(5 * board->planeWords, sizeof(uint64_t));
+    solver->work = malloc(BOARD_INITIAL_SEEDS * sizeof(uint32_t));
+    solver->safeQueue = malloc(BOARD_INITIAL_SEEDS * sizeof(uint32_t));
+    solver->cacheKeys = malloc(SOLVER_CACHE_VALUES * sizeof(uint32_t));
+    solver->cacheValues = malloc(SOLVER_CACHE_VALUES * sizeof(double));
+    solver->constraints = malloc(BOARD_INITIAL_SEEDS * sizeof(SolverConstraint));
+    solver->values = malloc(BOARD_INITIAL_SEEDS * sizeof(double));
+    size_t cells = (size_t)board->width * (size_t)board->height;
+    solver->unknownCells = malloc(cells * sizeof(uint32_t));
+    solver->unknownSlot = malloc(cells * sizeof(uint32_t));
+    solver->openCells = malloc(BOARD_INITIAL_SEEDS * sizeof(uint32_t));
+    if (solver->storage == NULL || solver->work == NULL || solver->safeQueue == NULL ||
+        solver->cacheKeys == NULL || solver->cacheValues == NULL || solver->constraints == NULL ||
+        solver->values == NULL || solver->unknownCells == NULL || solver->unknownSlot == NULL ||
+        solver->openCells == NULL) {
+        free(solver->storage);
+        free(solver->work);
+        free(solver->safeQueue);
+        free(solver->cacheKeys);
+        free(solver->cacheValues);
+        free(solver->constraints);
+        free(solver->values);
+        free(solver->unknownCells);
+        free(solver->unknownSlot);
+        free(solver->openCells);
+        return -1;
+    }
+    solver->openCapacity = BOARD_INITIAL_SEEDS;
+    solver->workCapacity = BOARD_INITIAL_SEEDS;
+    solver->safeCapacity = BOARD_INITIAL_SEEDS;
+    solver->constraintCapacity = BOARD_INITIAL_SEEDS;
+    solver->valueCapacity = BOARD_INITIAL_SEEDS;
+    solver->cacheKeyCapacity = SOLVER_CACHE_VALUES;
+    uint64_t *planes = solver->storage;
+    solver->seen = planes;
+    solver->mine = planes + board->planeWords;
+    solver->safe = planes + 2 * board->planeWords;
+    solver->open = planes + 3 * board->planeWords;
+    solver->queued = planes + 4 * board->planeWords;
+    clearSolverCache(solver);
+    resetSolver(solver);
+    return 0;
+}
+
+static inline void freeSolver(Solver *solver) {
+    free(solver->storage);
+    free(solver->work);
+    free(solver->safeQueue);
+    free(solver->constraints);
+    free(solver->varCells);
+    free(solver->varParent);
+    free(solver->varComponent);
+    free(solver->varLocal);
+    free(solver->probability);
+    free(solver->varTable);
+    free(solver->componentVars);
+    free(solver->componentConstraints);
+    free(solver->componentStart);
+    free(solver->componentConstraintStart);
+    free(solver->componentValues);
+    free(solver->componentExact);
+    free(solver->values);
+    free(solver->cacheKeys);
+    free(solver->cacheValues);
+    free(solver->unknownCells);
+    free(solver->unknownSlot);
+    free(solver->openCells);
+    memset(solver, 0, sizeof(*solver));
+}
+
+static inline int solverUnknown(const Solver *solver, int row, int col) {
+    size_t word = solverWord(solver, row, col);
+    return !((solver->seen[word] | solver->mine[word] | solver->safe[word]) & boardBit(col));
+}
+
+// Take a cell off the unknown list as it is seen or decided; call before
+// setting its bit
+static inline void forgetSolverUnknown(Solver *solver, int row, int col) {
+    if (!solverUnknown(solver, row, col)) return;
+    uint32_t slot = solver->unknownSlot[(uint32_t)row * (uint32_t)solver->width + (uint32_t)col];
+    uint32_t last = solver->unknownCells[--solver->unknownCount];
+    solver->unknownCells[slot] = last;
+    solver->unknownSlot[last] = slot;
+}
+
+// Put a revealed numbered cell on the worklist unless it is already there
+static inline int pushSolverWork(Solver *solver, const Board *board, int row, int col) {
+    if (row < 0 || row >= solver->height || col < 0 || col >= solver->width) return 0;
+    if (!solverTest(solver->seen, solver, row, col) || solverTest(solver->mine, solver, row, col) ||
+        solverTest(solver->queued, solver, row, col) || boardAdjacentMines(board, row, col) == 0) {
+        return 0;
+    }
+    if (reserveBuffer((void **)&solver->work, &solver->workCapacity, solver->workCount, 1,
+                      sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    solverSet(solver->queued, solver, row, col);
+    solver->work[solver->workCount++] = (uint32_t)row * (uint32_t)solver->width + (uint32_t)col;
+    return 0;
+}
+
+// Requeue the numbered cells around (row, col), whose constraints it is in
+static inline int pushSolverNeighbours(Solver *solver, const Board *board, int row, int col) {
+    for (int n = 0; n < 8; n++) {
+        if (pushSolverWork(solver, board, row + solverNeighbours[n][0], col + solverNeighbours[n][1]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Record a deduced safe cell and hand it out on a later call
+static inline int markSolverSafe(Solver *solver, const Board *board, int row, int col) {
+    if (solverTest(solver->safe, solver, row, col)) return 0;
+    if (reserveBuffer((void **)&solver->safeQueue, &solver->safeCapacity, solver->safeCount, 1,
+                      sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    forgetSolverUnknown(solver, row, col);
+    solverSet(solver->safe, solver, row, col);
+    solver->safeQueue[solver->safeCount++] = (uint32_t)row * (uint32_t)solver->width + (uint32_t)col;
+    return pushSolverNeighbours(solver, board, row, col);
+}
+
+static inline int markSolverMine(Solver *solver, const Board *board, int row, int col) {
+    if (solverTest(solver->mine, solver, row, col)) return 0;
+    forgetSolverUnknown(solver, row, col);
+    solverSet(solver->mine, solver, row, col);
+    solver->knownMines++;
+    return pushSolverNeighbours(solver, board, row, col);
+}
+
+// Unknown neighbours of a numbered cell as a neighbour mask, their cells
+// (row * width + col) and the mines still missing around it
+static inline int solverConstraint(const Solver *solver, const Board *board, int row, int col,
+                                   uint32_t cells[8], int *remaining) {
+    int vars = 0;
+    int count = 0;
+    *remaining = boardAdjacentMines(board, row, col);
+    for (int n = 0; n < 8; n++) {
+        int r = row + solverNeighbours[n][0];
+        int c = col + solverNeighbours[n][1];
+        if (r < 0 || r >= solver->height || c < 0 || c >= solver->width) continue;
+        if (solverTest(solver->mine, solver, r, c)) {
+            (*remaining)--;
+        } else if (solverUnknown(solver, r, c)) {
+            vars |= 1 << n;
+            cells[count++] = (uint32_t)r * (uint32_t)solver->width + (uint32_t)c;
+        }
+    }
+    return vars;
+}
+
+// Take in one revealed cell
+static inline int takeSolverCell(Solver *solver, const Board *board, int row, int col) {
+    if (solverTest(solver->seen, solver, row, col)) return 0;
+    // A revealed mine (a game that lets play go on) is a known mine
+    if (boardIsMine(board, row, col)) return markSolverMine(solver, board, row, col);
+    forgetSolverUnknown(solver, row, col);
+    solverSet(solver->seen, solver, row, col);
+    if (pushSolverWork(solver, board, row, col) != 0 || pushSolverNeighbours(solver, board, row, col) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Take in the cells revealed on the board since the last call: the spans of
+// its last reveal if that was the only one, otherwise every plane word
+static inline int updateSolver(Solver *solver, const Board *board) {
+    if (!solver->rescan && board->reveals == solver->boardReveals + 1) {
+        for (size_t s = 0; s < board->spanCount; s++) {
+            const RevealSpan *span = &board->spans[s];
+            for (int col = span->first; col <= span->last; col++) {
+                if (takeSolverCell(solver, board, span->row, col) != 0) return -1;
+            }
+        }
+    } else if (solver->rescan || board->reveals != solver->boardReveals) {
+        int rowWords = solver->rowWords;
+        for (size_t i = (size_t)rowWords; i < (size_t)(solver->height + 1) * rowWords; i++) {
+            uint64_t fresh = board->revealed[i] & ~solver->seen[i];
+            while (fresh) {
+                int row = (int)(i / rowWords) - 1;
+                int col = (int)(i % rowWords) * 64 + __builtin_ctzll(fresh) - 1;
+                fresh &= fresh - 1;
+                if (takeSolverCell(solver, board, row, col) != 0) return -1;
+            }
+        }
+    }
+    solver->boardReveals = board->reveals;
+    solver->rescan = 0;
+    return 0;
+}
+
+// Mark listed cells as mines or safe
+static inline int markSolverCells(Solver *solver, const Board *board, const uint32_t *cells, int count, int mines) {
+    for (int i = 0; i < count; i++) {
+        int row = (int)(cells[i] / (uint32_t)solver->width);
+        int col = (int)(cells[i] % (uint32_t)solver->width);
+        int failed = mines ? markSolverMine(solver, board, row, col) : markSolverSafe(solver, board, row, col);
+        if (failed) return -1;
+    }
+    return 0;
+}
+
+// Cells of a that are not in b; returns how many
+static inline int solverDifference(const uint32_t *a, int countA, const uint32_t *b, int countB, uint32_t *out) {
+    int count = 0;
+    for (int i = 0; i < countA; i++) {
+        int found = 0;
+        for (int j = 0; j < countB; j++) found |= a[i] == b[j];
+        if (!found) out[count++] = a[i];
+    }
+    return count;
+}
+
+// Pairwise rule for two overlapping numbered cells: the mines of the cells
+// only other sees, minus those of the cells only here sees, equal the
+// difference of the counts. When that difference is as large as the cells
+// only other sees, they are all mines and the cells only here sees are safe.
+// Returns 1 if anything was marked.
+static inline int applySolverPair(Solver *solver, const Board *board,
+                                  const uint32_t *here, int hereCount, int hereRemaining,
+                                  const uint32_t *other, int otherCount, int otherRemaining) {
+    uint32_t onlyHere[8];
+    uint32_t onlyOther[8];
+    int onlyHereCount = solverDifference(here, hereCount, other, otherCount, onlyHere);
+    int onlyOtherCount = solverDifference(other, otherCount, here, hereCount, onlyOther);
+    if (onlyHereCount == hereCount || onlyHereCount + onlyOtherCount == 0 ||
+        otherRemaining - hereRemaining != onlyOtherCount) {
+        return 0;
+    }
+    if (markSolverCells(solver, board, onlyOther, onlyOtherCount, 1) != 0 ||
+        markSolverCells(solver, board, onlyHere, onlyHereCount, 0) != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+// Apply the single-cell and pairwise rules until the worklist is empty
+static inline int propagateSolver(Solver *solver, const Board *board) {
+    while (solver->workCount > 0) {
+        uint32_t cell = solver->work[--solver->workCount];
+        int row = (int)(cell / (uint32_t)solver->width);
+        int col = (int)(cell % (uint32_t)solver->width);
+        solverClear(solver->queued, solver, row, col);
+
+        uint32_t cells[8];
+        int remaining;
+        int count = __builtin_popcount(solverConstraint(solver, board, row, col, cells, &remaining));
+        if (count == 0 || remaining == 0 || remaining == count) {
+            solverClear(solver->open, solver, row, col);
+            if (markSolverCells(solver, board, cells, count, remaining != 0) != 0) return -1;
+            continue;
+        }
+        if (!solverTest(solver->open, solver, row, col)) {
+            if (reserveBuffer((void **)&solver->openCells, &solver->openCapacity, solver->openCount, 1,
+                              sizeof(uint32_t)) != 0) {
+                return -1;
+            }
+            solverSet(solver->open, solver, row, col);
+            solver->openCells[solver->openCount++] = cell;
+        }
+
+        // Numbered cells up to two away share unknown neighbours with this one
+        int changed = 0;
+        for (int dr = -2; dr <= 2 && !changed; dr++) {
+            for (int dc = -2; dc <= 2 && !changed; dc++) {
+                int r = row + dr;
+                int c = col + dc;
+                if ((dr == 0 && dc == 0) || r < 0 || r >= solver->height || c < 0 || c >= solver->width ||
+                    !solverTest(solver->open, solver, r, c)) {
+                    continue;
+                }
+                uint32_t otherCells[8];
+                int otherRemaining;
+                int otherCount = __builtin_popcount(
+                    solverConstraint(solver, board, r, c, otherCells, &otherRemaining));
+                changed = applySolverPair(solver, board, cells, count, remaining,
+                                          otherCells, otherCount, otherRemaining);
+                if (changed == 0) {
+                    changed = applySolverPair(solver, board, otherCells, otherCount, otherRemaining,
+                                              cells, count, remaining);
+                }
+                if (changed < 0) return -1;
+            }
+        }
+        // This cell's own unknowns may not have changed; look at it again
+        if (changed && pushSolverWork(solver, board, row, col) != 0) return -1;
+    }
+    return 0;
+}
+
+// Values stored for a component of vars variables: exact results hold the
+// layouts per mine count, then each variable's layouts with it as a mine
+// per mine count; estimates hold one mine chance per variable
+static inline size_t solverValueCount(int vars, int exact) {
+    return exact ? (size_t)(vars + 1) * (size_t)(vars + 1) : (size_t)vars;
+}
+
+// Make room for count variables in every per-variable array, and keep the
+// cell table at most half full
+static inline int reserveSolverVars(Solver *solver, size_t count) {
+    if (count > solver->varCapacity) {
+        size_t grown = solver->varCapacity ? solver->varCapacity * 2 : 256;
+        while (grown < count) grown *= 2;
+        void *cells = realloc(solver->varCells, grown * sizeof(uint32_t));
+        if (cells == NULL) return -1;
+        solver->varCells = cells;
+        int **ints[] = {&solver->varParent, &solver->varLocal, &solver->varComponent,
+                        &solver->componentVars, &solver->componentConstraints, &solver->componentStart,
+                        &solver->componentConstraintStart, &solver->componentExact};
+        for (size_t a = 0; a < sizeof(ints) / sizeof(ints[0]); a++) {
+            int *larger = realloc(*ints[a], (grown + 1) * sizeof(int));
+            if (larger == NULL) return -1;
+            *ints[a] = larger;
+        }
+        double *probability = realloc(solver->probability, grown * sizeof(double));
+        size_t *offsets = realloc(solver->componentValues, grown * sizeof(size_t));
+        if (probability != NULL) solver->probability = probability;
+        if (offsets != NULL) solver->componentValues = offsets;
+        if (probability == NULL || offsets == NULL) return -1;
+        solver->varCapacity = grown;
+    }
+    if (2 * count > solver->varTableSize) {
+        size_t size = solver->varTableSize ? solver->varTableSize : 1024;
+        while (size < 2 * count) size *= 2;
+        int *table = realloc(solver->varTable, size * sizeof(int));
+        if (table == NULL) return -1;
+        solver->varTable = table;
+        solver->varTableSize = size;
+        memset(table, -1, size * sizeof(int));
+        for (size_t v = 0; v < solver->varCount; v++) {
+            size_t slot = (size_t)(solver->varCells[v] * 0x9E3779B97F4A7C15ULL >> 32) & (size - 1);
+            while (table[slot] >= 0) slot = (slot + 1) & (size - 1);
+            table[slot] = (int)v;
+        }
+    }
+    return 0;
+}
+
+// Slot of a cell in the variable table: its own, or the empty one it would take
+static inline size_t solverVarSlot(const Solver *solver, uint32_t cell) {
+    size_t mask = solver->varTableSize - 1;
+    size_t slot = (size_t)(cell * 0x9E3779B97F4A7C15ULL >> 32) & mask;
+    while (solver->varTable[slot] >= 0 && solver->varCells[solver->varTable[slot]] != cell) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Variable of a frontier cell, added if new; returns -1 if memory ran out
+static inline int solverVariable(Solver *solver, uint32_t cell) {
+    if (reserveSolverVars(solver, solver->varCount + 1) != 0) return -1;
+    size_t slot = solverVarSlot(solver, cell);
+    if (solver->varTable[slot] < 0) {
+        int v = (int)solver->varCount++;
+        solver->varCells[v] = cell;
+        solver->varParent[v] = v;
+        solver->varTable[slot] = v;
+    }
+    return solver->varTable[slot];
+}
+
+static inline int findSolverRoot(Solver *solver, int v) {
+    while (solver->varParent[v] != v) {
+        solver->varParent[v] = solver->varParent[solver->varParent[v]];
+        v = solver->varParent[v];
+    }
+    return v;
+}
+
+// Gather the open numbered cells and their unknown neighbours, and split
+// them into components that share no unknown cell. Closed cells are dropped
+// from the open list on the way.
+static inline int collectSolverFrontier(Solver *solver, const Board *board) {
+    size_t kept = 0;
+    solver->constraintCount = 0;
+    solver->varCount = 0;
+    if (reserveSolverVars(solver, 1) != 0) return -1;
+    memset(solver->varTable, -1, solver->varTableSize * sizeof(int));
+
+    for (size_t k = 0; k < solver->openCount; k++) {
+        uint32_t cell = solver->openCells[k];
+        int row = (int)(cell / (uint32_t)solver->width);
+        int col = (int)(cell % (uint32_t)solver->width);
+        if (!solverTest(solver->open, solver, row, col)) continue;
+        uint32_t cells[8];
+        SolverConstraint constraint;
+        constraint.cell = cell;
+        constraint.vars = solverConstraint(solver, board, row, col, cells, &constraint.remaining);
+        constraint.count = __builtin_popcount(constraint.vars);
+        if (constraint.count == 0) {
+            solverClear(solver->open, solver, row, col);
+            continue;
+        }
+        solver->openCells[kept++] = cell;
+        for (int j = 0; j < constraint.count; j++) {
+            if ((constraint.var[j] = solverVariable(solver, cells[j])) < 0) return -1;
+            int a = findSolverRoot(solver, constraint.var[0]);
+            int b = findSolverRoot(solver, constraint.var[j]);
+            solver->varParent[b] = a;
+        }
+        if (reserveBuffer((void **)&solver->constraints, &solver->constraintCapacity,
+                          solver->constraintCount, 1, sizeof(SolverConstraint)) != 0) {
+            return -1;
+        }
+        solver->constraints[solver->constraintCount++] = constraint;
+    }
+    solver->openCount = kept;
+
+    // Number the components in order of their first variable, then lay out
+    // their variables and constraints as runs with a counting sort
+    size_t vars = solver->varCount;
+    size_t constraints = solver->constraintCount;
+    if (reserveSolverVars(solver, (vars > constraints ? vars : constraints) + 1) != 0) return -1;
+    for (size_t v = 0; v < vars; v++) {
+        solver->varLocal[v] = findSolverRoot(solver, (int)v);
+        solver->varComponent[v] = -1;
+    }
+    solver->componentCount = 0;
+    for (size_t v = 0; v < vars; v++) {
+        int root = solver->varLocal[v];
+        if (solver->varComponent[root] < 0) solver->varComponent[root] = (int)solver->componentCount++;
+        solver->varComponent[v] = solver->varComponent[root];
+    }
+    size_t components = solver->componentCount;
+    int *start = solver->componentStart;
+    int *constraintStart = solver->componentConstraintStart;
+    int *filled = solver->componentExact;
+    memset(start, 0, (components + 1) * sizeof(int));
+    memset(constraintStart, 0, (components + 1) * sizeof(int));
+    for (size_t v = 0; v < vars; v++) start[solver->varComponent[v] + 1]++;
+    for (size_t k = 0; k < constraints; k++) {
+        constraintStart[solver->varComponent[solver->constraints[k].var[0]] + 1]++;
+    }
+    for (size_t c = 0; c < components; c++) {
+        start[c + 1] += start[c];
+        constraintStart[c + 1] += constraintStart[c];
+    }
+    memset(filled, 0, components * sizeof(int));
+    for (size_t v = 0; v < vars; v++) {
+        int c = solver->varComponent[v];
+        solver->varLocal[v] = filled[c]++;
+        solver->componentVars[start[c] + solver->varLocal[v]] = (int)v;
+    }
+    memset(filled, 0, components * sizeof(int));
+    for (size_t k = 0; k < constraints; k++) {
+        int c = solver->varComponent[solver->constraints[k].var[0]];
+        solver->componentConstraints[constraintStart[c] + filled[c]++] = (int)k;
+    }
+    return 0;
+}
+
+// Backtracking state for one component: variables are assigned in run
+// order, and each constraint tracks the mines assigned and the variables
+// left so dead ends are cut as soon as a count can no longer be met
+typedef struct {
+    int vars;
+    int remaining[8 * SOLVER_MAX_COMPONENT];
+    int mines[8 * SOLVER_MAX_COMPONENT];
+    int unassigned[8 * SOLVER_MAX_COMPONENT];
+    int varConstraints[SOLVER_MAX_COMPONENT][8];
+    int varConstraintCount[SOLVER_MAX_COMPONENT];
+    unsigned char assigned[SOLVER_MAX_COMPONENT];
+    long nodes;
+    double *layouts;
+} SolverSearch;
+
+// Count the layouts of variables depth.. given the mines placed so far;
+// returns -1 once the node budget is spent
+static inline int searchSolverLayouts(SolverSearch *search, int depth, int mines) {
+    if (++search->nodes > SOLVER_MAX_NODES) return -1;
+    int vars = search->vars;
+    if (depth == vars) {
+        search->layouts[mines] += 1;
+        for (int v = 0; v < vars; v++) {
+            if (search->assigned[v]) search->layouts[(size_t)(vars + 1) * (v + 1) + mines] += 1;
+        }
+        return 0;
+    }
+    for (int value = 0; value <= 1; value++) {
+        int feasible = 1;
+        for (int j = 0; j < search->varConstraintCount[depth]; j++) {
+            int k = search->varConstraints[depth][j];
+            search->unassigned[k]--;
+            search->mines[k] += value;
+            if (search->mines[k] > search->remaining[k] ||
+                search->mines[k] + search->unassigned[k] < search->remaining[k]) {
+                feasible = 0;
+            }
+        }
+        int failed = 0;
+        if (feasible) {
+            search->assigned[depth] = (unsigned char)value;
+            failed = searchSolverLayouts(search, depth + 1, mines + value);
+        }
+        for (int j = 0; j < search->varConstraintCount[depth]; j++) {
+            int k = search->varConstraints[depth][j];
+            search->unassigned[k]++;
+            search->mines[k] -= value;
+        }
+        if (failed) return -1;
+    }
+    return 0;
+}
+
+// Fill values with the results of component c: exact layout counts, or if
+// it is too large for them, each variable's highest count ratio as its mine
+// chance. Returns whether the result is exact.
+static inline int solveSolverComponent(Solver *solver, size_t c, double *values) {
+    int first = solver->componentStart[c];
+    int vars = solver->componentStart[c + 1] - first;
+    int firstConstraint = solver->componentConstraintStart[c];
+    int constraints = solver->componentConstraintStart[c + 1] - firstConstraint;
+
+    if (vars <= SOLVER_MAX_COMPONENT) {
+        SolverSearch search;
+        search.vars = vars;
+        search.nodes = 0;
+        search.layouts = values;
+        memset(values, 0, solverValueCount(vars, 1) * sizeof(double));
+        memset(search.varConstraintCount, 0, (size_t)vars * sizeof(int));
+        for (int j = 0; j < constraints; j++) {
+            const SolverConstraint *k = &solver->constraints[solver->componentConstraints[firstConstraint + j]];
+            search.remaining[j] = k->remaining;
+            search.mines[j] = 0;
+            search.unassigned[j] = k->count;
+            for (int n = 0; n < k->count; n++) {
+                int local = solver->varLocal[k->var[n]];
+                search.varConstraints[local][search.varConstraintCount[local]++] = j;
+            }
+        }
+        if (searchSolverLayouts(&search, 0, 0) == 0) return 1;
+    }
+
+    for (int v = 0; v < vars; v++) values[v] = 0;
+    for (int j = 0; j < constraints; j++) {
+        const SolverConstraint *k = &solver->constraints[solver->componentConstraints[firstConstraint + j]];
+        double ratio = (double)k->remaining / k->count;
+        for (int n = 0; n < k->count; n++) {
+            int local = solver->varLocal[k->var[n]];
+            if (ratio > values[local]) values[local] = ratio;
+        }
+    }
+    return 0;
+}
+
+// Results of every component into solver->values, from the cache where the
+// same component (same cells, counts and unknown neighbours) was solved before
+static inline int solveSolverComponents(Solver *solver) {
+    solver->valueCount = 0;
+    for (size_t c = 0; c < solver->componentCount; c++) {
+        int vars = solver->componentStart[c + 1] - solver->componentStart[c];
+        int firstConstraint = solver->componentConstraintStart[c];
+        int constraints = solver->componentConstraintStart[c + 1] - firstConstraint;
+        size_t room = solverValueCount(vars, vars <= SOLVER_MAX_COMPONENT);
+        if (reserveBuffer((void **)&solver->values, &solver->valueCapacity, solver->valueCount, room,
+                          sizeof(double)) != 0) {
+            return -1;
+        }
+        double *values = solver->values + solver->valueCount;
+        solver->componentValues[c] = solver->valueCount;
+        solver->valueCount += room;
+
+        // Only components that can be counted exactly are worth a cache slot
+        size_t keyLength = 2 * (size_t)constraints;
+        if (vars > SOLVER_MAX_COMPONENT || keyLength > SOLVER_CACHE_VALUES / 4) {
+            solver->componentExact[c] = solveSolverComponent(solver, c, values);
+            continue;
+        }
+        // Start over when the table is half full or storage runs out
+        if (solver->cacheEntries >= SOLVER_CACHE_SLOTS / 2 ||
+            solver->cacheKeyCount + keyLength > SOLVER_CACHE_VALUES ||
+            solver->cacheValueCount + room > SOLVER_CACHE_VALUES) {
+            clearSolverCache(solver);
+        }
+
+        // Key: each constraint's cell, then its count and unknown mask
+        uint32_t *key = solver->cacheKeys + solver->cacheKeyCount;
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (int j = 0; j < constraints; j++) {
+            const SolverConstraint *k = &solver->constraints[solver->componentConstraints[firstConstraint + j]];
+            key[2 * j] = k->cell;
+            key[2 * j + 1] = (uint32_t)k->remaining << 8 | (uint32_t)k->vars;
+            hash = (hash ^ key[2 * j]) * 0x100000001B3ULL;
+            hash = (hash ^ key[2 * j + 1]) * 0x100000001B3ULL;
+        }
+        size_t slot = (size_t)(hash >> 32) & (SOLVER_CACHE_SLOTS - 1);
+        SolverCacheEntry *entry = &solver->cache[slot];
+        while (entry->vars >= 0 && !(entry->hash == hash && entry->keyLength == keyLength &&
+                                     memcmp(solver->cacheKeys + entry->keyOffset, key,
+                                            keyLength * sizeof(uint32_t)) == 0)) {
+            slot = (slot + 1) & (SOLVER_CACHE_SLOTS - 1);
+            entry = &solver->cache[slot];
+        }
+        if (entry->vars >= 0) {
+            solver->cacheHits++;
+            solver->componentExact[c] = entry->exact;
+            memcpy(values, solver->cacheValues + entry->valueOffset,
+                   solverValueCount(vars, entry->exact) * sizeof(double));
+            continue;
+        }
+        solver->cacheMisses++;
+        int exact = solveSolverComponent(solver, c, values);
+        size_t stored = solverValueCount(vars, exact);
+        solver->componentExact[c] = exact;
+        *entry = (SolverCacheEntry){hash, (uint32_t)solver->cacheKeyCount, (uint32_t)keyLength,
+                                    (uint32_t)solver->cacheValueCount, vars, exact};
+        memcpy(solver->cacheValues + solver->cacheValueCount, values, stored * sizeof(double));
+        solver->cacheKeyCount += keyLength;
+        solver->cacheValueCount += stored;
+        solver->cacheEntries++;
+    }
+    return 0;
+}
+
+// Weights of k = 0..frontier mines on the frontier: proportional to the ways
+// C(unconstrained, mines - k) of placing the rest off it. Neighbouring
+// weights differ by an exact ratio, so no factorials or logarithms are
+// needed; the run is rescaled whenever it grows too large for a double.
+static inline void solverBinomialWeights(double *weights, int frontier, long unconstrained, long mines) {
+    for (int k = 0; k <= frontier; k++) weights[k] = 0;
+    int k = frontier < mines ? frontier : (int)mines;
+    long rest = mines - k;
+    if (k < 0 || rest > unconstrained) return;
+    double value = 1;
+    for (;;) {
+        weights[k] = value;
+        if (k == 0 || rest + 1 > unconstrained) break;
+        value *= (double)(unconstrained - rest) / (double)(rest + 1);
+        rest++;
+        k--;
+        if (value > 1e280) {
+            for (int j = k + 1; j <= frontier; j++) weights[j] *= 1e-280;
+            value *= 1e-280;
+        }
+    }
+}
+
+// out = a * b as polynomials in the mine count; returns out's length
+static inline int convolveSolver(const double *a, int lengthA, const double *b, int lengthB, double *out) {
+    for (int k = 0; k < lengthA + lengthB - 1; k++) out[k] = 0;
+    for (int i = 0; i < lengthA; i++) {
+        if (a[i] == 0) continue;
+        for (int j = 0; j < lengthB; j++) out[i + j] += a[i] * b[j];
+    }
+    return lengthA + lengthB - 1;
+}
+
+// Mine chance of each variable of exact component c given the weight of
+// each mine count in it, marking variables that are a mine or safe in
+// every layout with weight
+static inline int weighSolverComponent(Solver *solver, const Board *board, size_t c,
+                                       const double *factor, double total) {
+    int first = solver->componentStart[c];
+    int vars = solver->componentStart[c + 1] - first;
+    const double *layouts = solver->values + solver->componentValues[c];
+    for (int v = 0; v < vars; v++) {
+        const double *asMine = layouts + (size_t)(vars + 1) * (v + 1);
+        double chance = 0;
+        int always = 1;
+        int never = 1;
+        for (int m = 0; m <= vars; m++) {
+            if (factor[m] == 0 || layouts[m] == 0) continue;
+            chance += asMine[m] * factor[m];
+            always &= asMine[m] == layouts[m];
+            never &= asMine[m] == 0;
+        }
+        int var = solver->componentVars[first + v];
+        solver->probability[var] = total > 0 ? chance / total : 0;
+        int row = (int)(solver->varCells[var] / (uint32_t)solver->width);
+        int col = (int)(solver->varCells[var] % (uint32_t)solver->width);
+        if (never && markSolverSafe(solver, board, row, col) != 0) return -1;
+        if (always && !never && markSolverMine(solver, board, row, col) != 0) return -1;
+    }
+    return 0;
+}
+
+// Hidden cell off the frontier to guess: a corner, where an empty cell is
+// most likely to open an area, else the first listed one
+static inline int pickSolverUnconstrained(Solver *solver, int *row, int *col) {
+    const int corners[4][2] = {
+        {0, 0}, {0, solver->width - 1}, {solver->height - 1, 0}, {solver->height - 1, solver->width - 1}
+    };
+    for (int i = 0; i < 4; i++) {
+        uint32_t cell = (uint32_t)corners[i][0] * (uint32_t)solver->width + (uint32_t)corners[i][1];
+        if (solverUnknown(solver, corners[i][0], corners[i][1]) &&
+            solver->varTable[solverVarSlot(solver, cell)] < 0) {
+            *row = corners[i][0];
+            *col = corners[i][1];
+            return 1;
+        }
+    }
+    // At most the frontier's cells are passed over before one off it
+    for (size_t k = 0; k < solver->unknownCount; k++) {
+        uint32_t cell = solver->unknownCells[k];
+        if (solver->varTable[solverVarSlot(solver, cell)] < 0) {
+            *row = (int)(cell / (uint32_t)solver->width);
+            *col = (int)(cell % (uint32_t)solver->width);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Mark every hidden cell off the frontier as a mine or safe. Marking moves
+// the last listed cell into the marked one's place, so the list is walked
+// from the end.
+static inline int markSolverUnconstrained(Solver *solver, const Board *board, int mines) {
+    for (size_t k = solver->unknownCount; k-- > 0;) {
+        uint32_t cell = solver->unknownCells[k];
+        if (solver->varTable[solverVarSlot(solver, cell)] >= 0) continue;
+        int row = (int)(cell / (uint32_t)solver->width);
+        int col = (int)(cell % (uint32_t)solver->width);
+        int failed = mines ? markSolverMine(solver, board, row, col) : markSolverSafe(solver, board, row, col);
+        if (failed) return -1;
+    }
+    return 0;
+}
+
+// Enumerate the frontier and either deduce more mines or safe cells
+// (returns 2) or pick the safest guess (returns 1). Returns 0 when no hidden
+// cell is left, or -1 if memory ran out.
+static inline int chooseSolverMove(Solver *solver, const Board *board, SolverMove *move) {
+    long unknown = (long)solver->unknownCount;
+    if (unknown == 0) return 0;
+    if (collectSolverFrontier(solver, board) != 0 || solveSolverComponents(solver) != 0) return -1;
+
+    int frontier = (int)solver->varCount;
+    long unconstrained = unknown - frontier;
+    long mines = board->mines - solver->knownMines;
+    size_t components = solver->componentCount;
+    size_t known = solver->knownMines + solver->safeCount;
+    double unconstrainedChance = -1;
+    int unconstrainedCertain = -1;
+
+    // Each component's distribution over its mine count: its layouts, or a
+    // point mass at the expected count for one that was only estimated. The
+    // exact weighing also keeps the distribution of the components before
+    // each one, so it is only done for a frontier of moderate size.
+    int exact = frontier <= SOLVER_EXACT_FRONTIER;
+    size_t base = solver->valueCount;
+    size_t stride = (size_t)frontier + 1;
+    size_t need = components + (exact ? (components + 6) * stride : 0);
+    if (reserveBuffer((void **)&solver->values, &solver->valueCapacity, base, need, sizeof(double)) != 0) {
+        return -1;
+    }
+    double *estimates = solver->values + base;
+    double *weights = estimates + components;
+    double *total = weights + stride;
+    double *suffix = total + stride;
+    double *nextSuffix = suffix + stride;
+    double *combined = nextSuffix + stride;
+    double *prefix = combined + stride;
+    // Lengths of the prefix distributions; varParent is free once the
+    // components are laid out
+    int *length = solver->varParent;
+    double totalWeight = 0;
+
+    for (size_t c = 0; c < components; c++) {
+        int first = solver->componentStart[c];
+        int vars = solver->componentStart[c + 1] - first;
+        if (solver->componentExact[c]) continue;
+        double expected = 0;
+        for (int v = 0; v < vars; v++) {
+            expected += solver->values[solver->componentValues[c] + v];
+            solver->probability[solver->componentVars[first + v]] = solver->values[solver->componentValues[c] + v];
+        }
+        estimates[c] = (int)(expected + 0.5);
+    }
+
+    if (exact) {
+        prefix[0] = 1;
+        length[0] = 1;
+        for (size_t c = 0; c < components; c++) {
+            int vars = solver->componentStart[c + 1] - solver->componentStart[c];
+            const double *before = prefix + c * stride;
+            double *after = prefix + (c + 1) * stride;
+            if (solver->componentExact[c]) {
+                length[c + 1] = convolveSolver(before, length[c], solver->values + solver->componentValues[c],
+                                               vars + 1, after);
+            } else {
+                int shift = (int)estimates[c];
+                length[c + 1] = length[c] + shift;
+                for (int k = 0; k < length[c + 1]; k++) after[k] = k < shift ? 0 : before[k - shift];
+            }
+        }
+        memcpy(total, prefix + components * stride, (size_t)length[components] * sizeof(double));
+        for (int k = length[components]; k <= frontier; k++) total[k] = 0;
+        solverBinomialWeights(weights, frontier, unconstrained, mines);
+        for (int k = 0; k <= frontier; k++) totalWeight += total[k] * weights[k];
+    }
+
+    if (totalWeight > 0) {
+        // Exact: a component's factor for m mines is the weight of the other
+        // components' layouts combined with the mines left for the rest
+        int suffixLength = 1;
+        suffix[0] = 1;
+        for (size_t c = components; c-- > 0;) {
+            int vars = solver->componentStart[c + 1] - solver->componentStart[c];
+            int combinedLength = convolveSolver(prefix + c * stride, length[c], suffix, suffixLength, combined);
+            if (solver->componentExact[c]) {
+                double factor[SOLVER_MAX_COMPONENT + 1];
+                for (int m = 0; m <= vars; m++) {
+                    factor[m] = 0;
+                    for (int k = 0; k < combinedLength && k + m <= frontier; k++) {
+                        factor[m] += combined[k] * weights[k + m];
+                    }
+                }
+                if (weighSolverComponent(solver, board, c, factor, totalWeight) != 0) return -1;
+                suffixLength = convolveSolver(solver->values + solver->componentValues[c], vars + 1,
+                                              suffix, suffixLength, nextSuffix);
+            } else {
+                int shift = (int)estimates[c];
+                for (int k = 0; k < suffixLength + shift; k++) nextSuffix[k] = k < shift ? 0 : suffix[k - shift];
+                suffixLength += shift;
+            }
+            double *swap = suffix;
+            suffix = nextSuffix;
+            nextSuffix = swap;
+        }
+        if (unconstrained > 0) {
+            double expected = 0;
+            int allSafe = 1;
+            int allMines = 1;
+            for (int k = 0; k <= frontier; k++) {
+                if (total[k] * weights[k] == 0) continue;
+                expected += total[k] * weights[k] * (double)(mines - k);
+                allSafe &= mines - k == 0;
+                allMines &= mines - k == unconstrained;
+            }
+            unconstrainedChance = expected / (double)unconstrained / totalWeight;
+            unconstrainedCertain = allSafe ? 0 : allMines ? 1 : -1;
+        }
+    } else {
+        // Independent: weigh each component's layouts at the average density
+        double density = (double)mines / (double)unknown;
+        if (density < 1e-6) density = 1e-6;
+        if (density > 1 - 1e-6) density = 1 - 1e-6;
+        double odds = density / (1 - density);
+        double expectedMines = 0;
+        for (size_t c = 0; c < components; c++) {
+            int first = solver->componentStart[c];
+            int vars = solver->componentStart[c + 1] - first;
+            if (!solver->componentExact[c]) {
+                for (int v = 0; v < vars; v++) expectedMines += solver->probability[solver->componentVars[first + v]];
+                continue;
+            }
+            const double *layouts = solver->values + solver->componentValues[c];
+            double factor[SOLVER_MAX_COMPONENT + 1];
+            double weight = 0;
+            double expected = 0;
+            factor[0] = 1;
+            for (int m = 0; m <= vars; m++) {
+                if (m > 0) factor[m] = factor[m - 1] * odds;
+                weight += layouts[m] * factor[m];
+                expected += m * layouts[m] * factor[m];
+            }
+            if (weight > 0) expectedMines += expected / weight;
+            if (weighSolverComponent(solver, board, c, factor, weight) != 0) return -1;
+        }
+        if (unconstrained > 0) {
+            unconstrainedChance = ((double)mines - expectedMines) / (double)unconstrained;
+            if (unconstrainedChance < 0) unconstrainedChance = 0;
+            if (unconstrainedChance > 1) unconstrainedChance = 1;
+        }
+    }
+
+    if (unconstrainedCertain >= 0 && markSolverUnconstrained(solver, board, unconstrainedCertain) != 0) {
+        return -1;
+    }
+    if (solver->knownMines + solver->safeCount != known) return 2;
+
+    // Nothing certain: guess the cell least likely to be a mine
+    int best = -1;
+    for (int v = 0; v < frontier; v++) {
+        if (best < 0 || solver->probability[v] < solver->probability[best]) best = v;
+    }
+    if (unconstrainedChance >= 0 && (best < 0 || unconstrainedChance < solver->probability[best]) &&
+        pickSolverUnconstrained(solver, &move->row, &move->col)) {
+        move->mineChance = unconstrainedChance;
+        return 1;
+    }
+    if (best < 0) return 0;
+    move->row = (int)(solver->varCells[best] / (uint32_t)solver->width);
+    move->col = (int)(solver->varCells[best] % (uint32_t)solver->width);
+    move->mineChance = solver->probability[best];
+    return 1;
+}
+
+// Next cell to reveal on the board: a deduced safe cell when there is one,
+// otherwise the cell least likely to be a mine. The move stays on offer
+// until it is revealed. Returns 1 with the move, 0 when no hidden cell is
+// left to try, or -1 if memory ran out.
+static inline int solverNextMove(Solver *solver, const Board *board, SolverMove *move) {
+    if (updateSolver(solver, board) != 0) return -1;
+    for (;;) {
+        if (propagateSolver(solver, board) != 0) return -1;
+        while (solver->safeCount > 0) {
+            uint32_t cell = solver->safeQueue[solver->safeCount - 1];
+            int row = (int)(cell / (uint32_t)solver->width);
+            int col = (int)(cell % (uint32_t)solver->width);
+            if (!boardIsRevealed(board, row, col)) {
+                *move = (SolverMove){row, col, 0};
+                return 1;
+            }
+            solver->safeCount--;
+        }
+        int result = chooseSolverMove(solver, board, move);
+        if (result != 2) return result;
+    }
+}
+
+#endif
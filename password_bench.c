@@ -0,0 +1,548 @@
+// Benchmark of password_generator.c, built as its own program so the
+// generator itself ships without timing code. It compiles the generator in
+// (without its main) to reach the internal kernels:
+//
+//     gcc -O2 -pthread password_bench.c -o password_bench
+#define PASSWORD_GENERATOR_LIBRARY
+#include "password_generator.c"
+
+#define BENCH_DEFAULT_COUNT 200000
+#define BENCH_DEFAULT_JSON_COUNT 100000
+#define BENCH_UNIFORMITY_LENGTH 16
+// Characters whose expected count at a position is below this are pooled
+// into one bucket, so the chi-square approximation holds
+#define BENCH_MIN_EXPECTED 5.0
+
+typedef struct {
+    PasswordConfig config;
+    unsigned long long count;
+    int threads;
+    int json;
+    const char *outputPath;
+    const char *markovPath;
+} BenchOptions;
+
+// Generators whose per-position character distribution is tested
+typedef enum {
+    BENCH_GENERATOR_COMPILED,
+    BENCH_GENERATOR_SEEDED,
+    BENCH_GENERATOR_POLICY,
+    BENCH_GENERATOR_PRONOUNCEABLE
+} BenchGenerator;
+
+static const char *benchGeneratorNames[] = {"compiled", "seeded", "policy", "pronounceable"};
+
+// Reference copy of the original generator, kept only as a benchmark baseline
+static void generatePasswordBaseline(char *password, PasswordConfig config) {
+    char charset[200] = "";
+
+    if (config.useLower) strcat(charset, LOWERCASE_CHARS);
+    if (config.useUpper) strcat(charset, UPPERCASE_CHARS);
+    if (config.useDigits) strcat(charset, DIGIT_CHARS);
+    if (config.useSpecial) strcat(charset, SPECIAL_CHARS);
+
+    for (int i = 0; i < config.length; i++) {
+        int randomIndex = rand() % strlen(charset);
+        password[i] = charset[randomIndex];
+    }
+    password[config.length] = '\0';
+}
+
+// Time count compiled-kernel passwords drawn from engine
+static double timeCompiledKernel(const PasswordConfig *config, RandomEngine *engine,
+                                 unsigned long long count, volatile char *sink) {
+    char password[MAX_PASSWORD_LENGTH];
+    CompiledCharset charset;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    compileCharset(&charset, config);
+    for (unsigned long long i = 0; i < count; i++) {
+        generatePasswordCompiled(password, config->length, &charset, engine);
+        *sink ^= password[0];
+    }
+    return elapsedSeconds(&start);
+}
+
+// Wall time of the real bulk path, chunking, worker pool, formatting and
+// ordered writes included, for count passwords written to /dev/null;
+// negative if the run failed
+static double timeBulkGeneration(const PasswordConfig *config, int threads, unsigned long long count) {
+    CommandLineOptions options;
+    struct timespec start;
+
+    memset(&options, 0, sizeof(options));
+    options.config = *config;
+    options.count = count;
+    options.outputPath = "/dev/null";
+    options.format = FORMAT_PLAIN;
+    options.threads = threads;
+    options.uniqueMemory = UNIQUE_DEFAULT_MEMORY;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int failed = runBulkGeneration(&options);
+    double seconds = elapsedSeconds(&start);
+    return failed ? -1.0 : seconds;
+}
+
+// Square and cube roots by Newton's method, so the report needs no libm
+static double benchSqrt(double x) {
+    double r = x > 1 ? x : 1;
+    if (x <= 0) return 0;
+    for (int i = 0; i < 64; i++) r = 0.5 * (r + x / r);
+    return r;
+}
+
+static double benchCbrt(double x) {
+    double r = x > 1 ? x : 1;
+    if (x <= 0) return 0;
+    for (int i = 0; i < 128; i++) r = (2 * r + x / (r * r)) / 3;
+    return r;
+}
+
+// Letter a pronounceable outcome is written as when word starts are capitalized
+static unsigned char markovOutcomeChar(uint32_t outcome) {
+    return (unsigned char)(outcome < 26 ? 'a' + outcome : 'A' + outcome - 26);
+}
+
+// Exact chance of each letter at each position of a capitalized
+// pronounceable password: the distribution over contexts is pushed through
+// the table, counting per context which of the 65536 draws keep each column
+static int markovExpected(const MarkovModel *model, int length, double (*expected)[256]) {
+    double *current = calloc(MARKOV_CONTEXTS, sizeof(double));
+    double *next = calloc(MARKOV_CONTEXTS, sizeof(double));
+    uint32_t (*kept)[MARKOV_OUTCOMES] = calloc(MARKOV_CONTEXTS, sizeof(*kept));
+    uint32_t (*drawn)[MARKOV_OUTCOMES] = calloc(MARKOV_CONTEXTS, sizeof(*drawn));
+    if (current == NULL || next == NULL || kept == NULL || drawn == NULL) {
+        free(current);
+        free(next);
+        free(kept);
+        free(drawn);
+        return -1;
+    }
+
+    for (uint32_t context = 0; context < MARKOV_CONTEXTS; context++) {
+        const uint64_t *row = model->table + context * MARKOV_OUTCOMES;
+        for (uint32_t draw = 0; draw < 65536; draw++) {
+            uint32_t scaled = draw * MARKOV_OUTCOMES;
+            uint32_t column = scaled >> 16;
+            drawn[context][column]++;
+            kept[context][column] += (scaled & 0xFFFF) < (uint32_t)(row[column] >> 48);
+        }
+    }
+
+    current[0] = 1;
+    for (int p = 0; p < length; p++) {
+        memset(expected[p], 0, sizeof(expected[p]));
+        memset(next, 0, MARKOV_CONTEXTS * sizeof(double));
+        for (uint32_t context = 0; context < MARKOV_CONTEXTS; context++) {
+            if (current[context] == 0) continue;
+            const uint64_t *row = model->table + context * MARKOV_OUTCOMES;
+            for (uint32_t column = 0; column < MARKOV_OUTCOMES; column++) {
+                double keep = current[context] * kept[context][column] / 65536.0;
+                double swap = current[context] * (drawn[context][column] - kept[context][column]) / 65536.0;
+                uint32_t alias = (uint32_t)(row[column] >> 32) & 0xFF;
+                expected[p][markovOutcomeChar(column)] += keep;
+                expected[p][markovOutcomeChar(alias)] += swap;
+                next[((uint32_t)row[column] & 0xFFFF) / MARKOV_OUTCOMES] += keep;
+                next[((uint32_t)(row[column] >> 16) & 0xFFFF) / MARKOV_OUTCOMES] += swap;
+            }
+        }
+        double *t = current;
+        current = next;
+        next = t;
+    }
+
+    free(current);
+    free(next);
+    free(kept);
+    free(drawn);
+    return 0;
+}
+
+// Chance of each character at every position under the generator: uniform
+// over the charset, or for the policy generator a mix of each class's pool
+// weighted by the share of positions the shuffle gives it
+static int generatorExpected(BenchGenerator generator, const CompiledCharset *charset,
+                             const PasswordPolicy *policy, const MarkovModel *model, int length,
+                             double (*expected)[256]) {
+    if (generator == BENCH_GENERATOR_PRONOUNCEABLE) {
+        return markovExpected(model, length, expected);
+    }
+    memset(expected[0], 0, sizeof(expected[0]));
+    for (int c = 0; c < charset->size; c++) {
+        expected[0][(unsigned char)charset->chars[c]] = 1.0 / charset->size;
+    }
+    if (generator == BENCH_GENERATOR_POLICY) {
+        const char *pools[4] = {LOWERCASE_CHARS, UPPERCASE_CHARS, DIGIT_CHARS, SPECIAL_CHARS};
+        const int minimums[4] = {policy->minLower, policy->minUpper, policy->minDigits, policy->minSpecial};
+        int required = 0;
+        for (int k = 0; k < 4; k++) required += minimums[k];
+        for (int c = 0; c < 256; c++) expected[0][c] *= (double)(length - required) / length;
+        for (int k = 0; k < 4; k++) {
+            size_t size = strlen(pools[k]);
+            for (size_t c = 0; c < size; c++) {
+                expected[0][(unsigned char)pools[k][c]] += (double)minimums[k] / length / size;
+            }
+        }
+    }
+    for (int p = 1; p < length; p++) memcpy(expected[p], expected[0], sizeof(expected[0]));
+    return 0;
+}
+
+// Chi-square statistic of each position of samples passwords from the
+// generator against its expected distribution, written as JSON arrays of
+// degrees of freedom and statistics; returns the largest Wilson-Hilferty
+// z-score (about N(0,1) for an unbiased generator)
+static double writeUniformity(FILE *out, BenchGenerator generator, const PasswordConfig *config,
+                              const PasswordPolicy *policy, const MarkovModel *model,
+                              RandomEngine *engine, unsigned long long samples) {
+    CompiledCharset charset;
+    char password[MAX_PASSWORD_LENGTH];
+    uint32_t key[8];
+    int length = config->length;
+    unsigned long long (*observed)[256] = calloc((size_t)length, sizeof(*observed));
+    double (*expected)[256] = malloc((size_t)length * sizeof(*expected));
+    double maxZ = 0;
+
+    compileCharset(&charset, config);
+    if (observed == NULL || expected == NULL || getrandom(key, sizeof(key), 0) != sizeof(key) ||
+        generatorExpected(generator, &charset, policy, model, length, expected) != 0) {
+        fprintf(out, "\"degreesOfFreedom\": [], \"chiSquare\": []");
+        free(observed);
+        free(expected);
+        return 0;
+    }
+    for (unsigned long long i = 0; i < samples; i++) {
+        switch (generator) {
+            case BENCH_GENERATOR_COMPILED:
+                generatePasswordCompiled(password, length, &charset, engine);
+                break;
+            case BENCH_GENERATOR_SEEDED:
+                generatePasswordAt(password, length, &charset, key, i, 0);
+                break;
+            case BENCH_GENERATOR_POLICY:
+                generatePasswordWithPolicy(password, length, &charset, policy, engine);
+                break;
+            case BENCH_GENERATOR_PRONOUNCEABLE:
+                generatePronounceable(password, length, model, 1, engine);
+                break;
+        }
+        for (int p = 0; p < length; p++) observed[p][(unsigned char)password[p]]++;
+    }
+
+    double chiSquares[MAX_PASSWORD_LENGTH];
+    fprintf(out, "\"degreesOfFreedom\": [");
+    for (int p = 0; p < length; p++) {
+        double chiSquare = 0;
+        double pooledExpected = 0;
+        unsigned long long pooledObserved = 0;
+        int buckets = 0;
+        for (int c = 0; c < 256; c++) {
+            double want = expected[p][c] * samples;
+            if (want < BENCH_MIN_EXPECTED) {
+                pooledExpected += want;
+                pooledObserved += observed[p][c];
+                continue;
+            }
+            double delta = (double)observed[p][c] - want;
+            chiSquare += delta * delta / want;
+            buckets++;
+        }
+        if (pooledExpected >= BENCH_MIN_EXPECTED) {
+            double delta = (double)pooledObserved - pooledExpected;
+            chiSquare += delta * delta / pooledExpected;
+            buckets++;
+        }
+        double df = buckets > 1 ? buckets - 1 : 1;
+        double z = (benchCbrt(chiSquare / df) - (1 - 2 / (9 * df))) / benchSqrt(2 / (9 * df));
+        if (z > maxZ) maxZ = z;
+        chiSquares[p] = chiSquare;
+        fprintf(out, "%s%d", p ? ", " : "", (int)df);
+    }
+    fprintf(out, "], \"chiSquare\": [");
+    for (int p = 0; p < length; p++) fprintf(out, "%s%.2f", p ? ", " : "", chiSquares[p]);
+    fprintf(out, "]");
+    free(observed);
+    free(expected);
+    return maxZ;
+}
+
+// One uniformity entry of the JSON report
+static void writeUniformityEntry(FILE *out, int first, BenchGenerator generator, const char *classes,
+                                 const PasswordConfig *config, const PasswordPolicy *policy,
+                                 const MarkovModel *model, RandomEngine *engine, unsigned long long samples) {
+    fprintf(out, "%s\n    {\"generator\": \"%s\", \"classes\": \"%s\", \"length\": %d, \"samples\": %llu, ",
+            first ? "" : ",", benchGeneratorNames[generator], classes, config->length, samples);
+    double maxZ = writeUniformity(out, generator, config, policy, model, engine, samples);
+    fprintf(out, ", \"maxZ\": %.3f}", maxZ);
+}
+
+// Full benchmark matrix as JSON: throughput of every class mix and length,
+// the kernel alone and the bulk path on 1 and --threads workers, strength
+// rating speed, and per-position uniformity of every generator
+static int runBenchmarkJson(const BenchOptions *options, const MarkovModel *model) {
+    static const int lengths[] = {8, 12, 16, 24, 32, 48, 64, 96, 127};
+    static const char *classLetters = "luds";
+    const size_t lengthCount = sizeof(lengths) / sizeof(lengths[0]);
+    unsigned long long count = options->count > 0 ? options->count : BENCH_DEFAULT_JSON_COUNT;
+    unsigned long long samples = count * 2 > 200000 ? count * 2 : 200000;
+    volatile char sink = 0;
+
+    FILE *out = stdout;
+    if (options->outputPath != NULL && strcmp(options->outputPath, "-") != 0) {
+        out = fopen(options->outputPath, "w");
+        if (out == NULL) {
+            fprintf(stderr, "Error: could not create '%s': %s\n", options->outputPath, strerror(errno));
+            return 1;
+        }
+    }
+    RandomEngine *engine = malloc(sizeof(RandomEngine));
+    if (engine == NULL || initChaChaEngine(engine) != 0) {
+        fprintf(stderr, "Error: could not set up random engines\n");
+        free(engine);
+        if (out != stdout) fclose(out);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"passwordsPerRun\": %llu,\n  \"threads\": %d,\n  \"throughput\": [", count, options->threads);
+    int first = 1;
+    for (int mask = 1; mask < 16; mask++) {
+        PasswordConfig config = {0, mask & 1, (mask >> 1) & 1, (mask >> 2) & 1, (mask >> 3) & 1,
+                                 PASSWORD_MODE_RANDOM, 6, '-'};
+        char classes[5];
+        int n = 0;
+        for (int c = 0; c < 4; c++) if (mask & (1 << c)) classes[n++] = classLetters[c];
+        classes[n] = '\0';
+
+        for (size_t l = 0; l < lengthCount; l++) {
+            config.length = lengths[l];
+            // The kernel alone, then the bulk path on one and on --threads workers
+            for (int pass = 0; pass < (options->threads > 1 ? 3 : 2); pass++) {
+                int threads = pass == 2 ? options->threads : 1;
+                double seconds = pass == 0 ? timeCompiledKernel(&config, engine, count, &sink)
+                                           : timeBulkGeneration(&config, threads, count);
+                if (seconds <= 0) continue;
+                fprintf(out, "%s\n    {\"path\": \"%s\", \"classes\": \"%s\", \"length\": %d, \"threads\": %d, "
+                        "\"passwordsPerSecond\": %.0f, \"bytesPerSecond\": %.0f, \"nsPerChar\": %.3f}",
+                        first ? "" : ",", pass == 0 ? "kernel" : "bulk", classes, config.length, threads,
+                        count / seconds, count * (double)config.length / seconds,
+                        seconds * 1e9 / (count * (double)config.length));
+                first = 0;
+            }
+        }
+    }
+
+    // Rating speed over a pool of generated passwords, scalar and SIMD
+    fprintf(out, "\n  ],\n  \"strength\": [");
+    PasswordConfig all = {0, 1, 1, 1, 1, PASSWORD_MODE_RANDOM, 6, '-'};
+    CompiledCharset charset;
+    compileCharset(&charset, &all);
+    char (*pool)[MAX_PASSWORD_LENGTH] = malloc(1024 * MAX_PASSWORD_LENGTH);
+    ClassifyFunction classifiers[2] = {selectClassifier(0), selectClassifier(1)};
+    for (size_t l = 0; pool != NULL && l < lengthCount; l++) {
+        double nanoseconds[2];
+        for (int i = 0; i < 1024; i++) generatePasswordCompiled(pool[i], lengths[l], &charset, engine);
+        for (int k = 0; k < 2; k++) {
+            struct timespec start;
+            int total = 0;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (unsigned long long i = 0; i < count; i++) {
+                const unsigned char *text = (const unsigned char *)pool[i & 1023];
+                total += evaluateStrength((size_t)lengths[l], classifiers[k](text, (size_t)lengths[l]));
+            }
+            nanoseconds[k] = elapsedSeconds(&start) * 1e9 / count;
+            sink ^= (char)total;
+        }
+        fprintf(out, "%s\n    {\"length\": %d, \"scalarNsPerPassword\": %.2f, \"simdNsPerPassword\": %.2f}",
+                l ? "," : "", lengths[l], nanoseconds[0], nanoseconds[1]);
+    }
+    free(pool);
+
+    // Every class mix on the streamed and the seeded path, then the policy
+    // and pronounceable generators against their own expected distributions
+    fprintf(out, "\n  ],\n  \"uniformity\": [");
+    first = 1;
+    for (int mask = 1; mask < 16; mask++) {
+        PasswordConfig config = {BENCH_UNIFORMITY_LENGTH, mask & 1, (mask >> 1) & 1, (mask >> 2) & 1,
+                                 (mask >> 3) & 1, PASSWORD_MODE_RANDOM, 6, '-'};
+        char classes[5];
+        int n = 0;
+        for (int c = 0; c < 4; c++) if (mask & (1 << c)) classes[n++] = classLetters[c];
+        classes[n] = '\0';
+
+        writeUniformityEntry(out, first, BENCH_GENERATOR_COMPILED, classes, &config, NULL, NULL, engine, samples);
+        writeUniformityEntry(out, 0, BENCH_GENERATOR_SEEDED, classes, &config, NULL, NULL, engine, samples);
+        first = 0;
+    }
+    PasswordPolicy policy = {2, 2, 2, 2, 0};
+    all.length = BENCH_UNIFORMITY_LENGTH;
+    writeUniformityEntry(out, 0, BENCH_GENERATOR_POLICY, "luds", &all, &policy, NULL, engine, samples);
+    if (model != NULL) {
+        writeUniformityEntry(out, 0, BENCH_GENERATOR_PRONOUNCEABLE, "lu", &all, NULL, model, engine, samples);
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    free(engine);
+    int failed = ferror(out);
+    if (out != stdout) failed = fclose(out) != 0 || failed;
+    if (failed) {
+        fprintf(stderr, "Error: could not write the benchmark report\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Compare the baseline generator with the compiled kernel on rand() and ChaCha20
+static int runBenchmark(const BenchOptions *options, const MarkovModel *model) {
+    static const int lengths[] = {8, 16, 32, 64, 127};
+    unsigned long long count = options->count > 0 ? options->count : BENCH_DEFAULT_COUNT;
+    PasswordConfig config = options->config;
+    char password[MAX_PASSWORD_LENGTH];
+    volatile char sink = 0;
+
+    RandomEngine *randEngine = malloc(sizeof(RandomEngine));
+    RandomEngine *chachaEngine = malloc(sizeof(RandomEngine));
+    if (randEngine == NULL || chachaEngine == NULL || initChaChaEngine(chachaEngine) != 0) {
+        fprintf(stderr, "Error: could not set up random engines\n");
+        free(randEngine);
+        free(chachaEngine);
+        return 1;
+    }
+    initRandEngine(randEngine);
+
+    printf("Benchmark: %llu passwords per run (ns per password)\n", count);
+    printf("%8s %12s %14s %16s %10s\n", "length", "baseline", "compiled+rand", "compiled+chacha", "speedup");
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        struct timespec start;
+        config.length = lengths[l];
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (unsigned long long i = 0; i < count; i++) {
+            generatePasswordBaseline(password, config);
+            sink ^= password[0];
+        }
+        double baseline = elapsedSeconds(&start);
+        double withRand = timeCompiledKernel(&config, randEngine, count, &sink);
+        double withChaCha = timeCompiledKernel(&config, chachaEngine, count, &sink);
+
+        printf("%8d %12.1f %14.1f %16.1f %9.2fx\n", config.length,
+               baseline * 1e9 / count, withRand * 1e9 / count, withChaCha * 1e9 / count,
+               withChaCha > 0 ? baseline / withChaCha : 0.0);
+    }
+
+    if (model != NULL) {
+        printf("\n%8s %16s %14s %8s\n", "length", "compiled+chacha", "pronounceable", "ratio");
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            struct timespec start;
+            config.length = lengths[l];
+            double compiled = timeCompiledKernel(&config, chachaEngine, count, &sink);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (unsigned long long i = 0; i < count; i++) {
+                generatePronounceable(password, config.length, model, config.useUpper, chachaEngine);
+                sink ^= password[0];
+            }
+            double pronounceable = elapsedSeconds(&start);
+
+            printf("%8d %16.1f %14.1f %7.2fx\n", config.length, compiled * 1e9 / count,
+                   pronounceable * 1e9 / count, compiled > 0 ? pronounceable / compiled : 0.0);
+        }
+    }
+
+    free(randEngine);
+    free(chachaEngine);
+    return 0;
+}
+
+static void printBenchUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --count N        Passwords per timed run (default %d, %d with --json)\n",
+            BENCH_DEFAULT_COUNT, BENCH_DEFAULT_JSON_COUNT);
+    fprintf(stderr, "  --no-lower       Exclude lowercase letters from the table (also --no-upper,\n");
+    fprintf(stderr, "                   --no-digits, --no-special)\n");
+    fprintf(stderr, "  --markov MODEL   Also time pronounceable passwords from a trained letter model\n");
+    fprintf(stderr, "                   and, with --json, test them against the model\n");
+    fprintf(stderr, "  --json           Run the full matrix (all class mixes, lengths 8-127, the kernel\n");
+    fprintf(stderr, "                   and the bulk path on 1 and --threads threads, strength rating,\n");
+    fprintf(stderr, "                   chi-square per position of every generator) and write it as JSON\n");
+    fprintf(stderr, "  --threads N      Bulk path workers for --json (default: all CPUs)\n");
+    fprintf(stderr, "  --output FILE    Write the JSON report to FILE instead of stdout\n");
+}
+
+static int parseBenchOptions(int argc, char *argv[], BenchOptions *options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        unsigned long long number;
+
+        if (strcmp(arg, "--count") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1) {
+                fprintf(stderr, "Error: --count expects a positive number\n");
+                return -1;
+            }
+            options->count = number;
+            i++;
+        } else if (strcmp(arg, "--threads") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number > 1024) {
+                fprintf(stderr, "Error: --threads expects a number between 1 and 1024\n");
+                return -1;
+            }
+            options->threads = (int)number;
+            i++;
+        } else if (strcmp(arg, "--output") == 0 || strcmp(arg, "--markov") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: %s expects a file name\n", arg);
+                return -1;
+            }
+            if (arg[2] == 'o') options->outputPath = value;
+            else options->markovPath = value;
+            i++;
+        } else if (strcmp(arg, "--no-lower") == 0) {
+            options->config.useLower = 0;
+        } else if (strcmp(arg, "--no-upper") == 0) {
+            options->config.useUpper = 0;
+        } else if (strcmp(arg, "--no-digits") == 0) {
+            options->config.useDigits = 0;
+        } else if (strcmp(arg, "--no-special") == 0) {
+            options->config.useSpecial = 0;
+        } else if (strcmp(arg, "--json") == 0) {
+            options->json = 1;
+        } else {
+            fprintf(stderr, "Error: unknown option %s\n", arg);
+            return -1;
+        }
+    }
+    if (!options->config.useLower && !options->config.useUpper &&
+        !options->config.useDigits && !options->config.useSpecial) {
+        fprintf(stderr, "Error: at least one character type must be enabled\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions options = {
+        .config = {12, 1, 1, 1, 1, PASSWORD_MODE_RANDOM, 6, '-'},
+        .threads = 1
+    };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 1) {
+        options.threads = cpus > 1024 ? 1024 : (int)cpus;
+    }
+    if (parseBenchOptions(argc, argv, &options) != 0) {
+        printBenchUsage(argv[0]);
+        return 1;
+    }
+    if (options.markovPath != NULL && loadMarkovModel(options.markovPath) != 0) {
+        fprintf(stderr, "Error: could not load letter model '%s': %s\n", options.markovPath, strerror(errno));
+        return 1;
+    }
+    srand((unsigned int)time(NULL));
+
+    if (options.json) {
+        return runBenchmarkJson(&options, activeMarkovModel);
+    }
+    return runBenchmark(&options, activeMarkovModel);
+}
@@ -1,240 +1,3652 @@
 
+#define _GNU_SOURCE
+#include <stdarg.h>
 #include <stdio.h> 
 #include <stdlib.h> 
 #include <time.h> 
 #include <string.h>
 #include <ctype.h>
-
-#define MAX_PASSWORD_LENGTH 128
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+#include "password_generator.h"
 
 #define MAX_PASSWORDS 50
 
+// Random bytes are produced this many at a time; one refill serves many passwords
+#define RANDOM_BUFFER_SIZE (64 * 1024)
+
+// Bulk mode streams into this buffer and flushes it in one write() per block
+#define OUTPUT_BUFFER_SIZE (4 * 1024 * 1024)
+
+// Output buffers are aligned to this so they can be handed to O_DIRECT
+#define OUTPUT_ALIGNMENT 4096
+
+// Most buffers sent to the output in one writev() call
+#define WRITEV_BATCH 64
+
+// Daemon mode: profiles served, pre-generated passwords kept per profile
+// (a power of two), and the most passwords one GET may ask for
+#define DAEMON_MAX_PROFILES 16
+#define DAEMON_RING_SIZE 1024
+#define DAEMON_MAX_BATCH 1000
+#define DAEMON_LINE_LIMIT 256
+
+// Wordlist entries longer than this are left out of the index
+#define MAX_WORD_LENGTH 32
+
+// Memory-mapped wordlist with its offset index. The index (offsets, then
+// lengths) is cached next to the list as FILE.idx and reused while the
+// list's size and mtime match the header; a freshly built index is kept in
+// memory, so an unwritable cache only costs the rebuild on the next start.
+#define WORDLIST_INDEX_MAGIC "PWWIDX01"
+
 typedef struct {
-    int length;
-    int useLower;
-    int useUpper;
-    int useDigits;
-    int useSpecial;
-} PasswordConfig;
+    char magic[8];
+    uint64_t sourceSize;
+    int64_t sourceMtimeSec;
+    int64_t sourceMtimeNsec;
+    uint32_t count;
+    uint32_t longestWord;
+} WordlistIndexHeader;
+
+typedef struct {
+    const char *text;
+    size_t textSize;
+    void *indexMap;
+    size_t indexSize;
+    void *indexMemory;
+    const uint32_t *offsets;
+    const unsigned char *lengths;
+    uint32_t count;
+    int longestWord;
+} Wordlist;
+
+// Order-2 letter model for pronounceable passwords. A context is the last two
+// symbols (0 = word boundary, 1-26 = a-z). Each context has an alias table
+// over 52 outcomes: continue the word with a-z, or end it and start the next
+// word with a-z, so every output character costs exactly one draw.
+#define MARKOV_MODEL_MAGIC "PWMARKV1"
+#define MARKOV_SYMBOLS 27
+#define MARKOV_CONTEXTS (MARKOV_SYMBOLS * MARKOV_SYMBOLS)
+#define MARKOV_OUTCOMES 52
+
+typedef struct {
+    char magic[8];
+    uint32_t symbols;
+    uint32_t outcomes;
+    uint64_t trainedWords;
+} MarkovModelHeader;
+
+// Alias table entries pack, from the top: a 24-bit acceptance threshold, the
+// 8-bit alias outcome, and the table rows (context * 52, which fits in 16
+// bits) that follow the alias and the column, so the walk never recomputes
+// contexts
+#define MARKOV_ENTRY(threshold, alias, aliasNext, columnNext) \
+    ((uint64_t)(threshold) << 40 | (uint64_t)(alias) << 32 | (uint64_t)(aliasNext) << 16 | (uint64_t)(columnNext))
+
+typedef struct {
+    void *map;
+    size_t mapSize;
+    const MarkovModelHeader *header;
+    const uint64_t *table;
+} MarkovModel;
+
+// Character class bits reported by the classifiers
+#define CLASS_LOWER   1
+#define CLASS_UPPER   2
+#define CLASS_DIGIT   4
+#define CLASS_SPECIAL 8
+
+// Buckets of showPasswordStrength(), in the order it tests them
+typedef enum {
+    STRENGTH_TOO_SHORT,
+    STRENGTH_WEAK,
+    STRENGTH_MEDIUM,
+    STRENGTH_STRONG,
+    STRENGTH_VERY_STRONG,
+    STRENGTH_BUCKETS
+} PasswordStrength;
+
+// Returns the CLASS_* bits present in len bytes of text
+typedef int (*ClassifyFunction)(const unsigned char *text, size_t len);
+
+typedef struct {
+    unsigned long long buckets[STRENGTH_BUCKETS];
+    unsigned long long lines;
+    unsigned long long bytes;
+    unsigned long long breached;
+} AuditHistogram;
+
+// On-disk breach index: header, prefix table of 2^prefixBits + 1 entry
+// offsets, Bloom filter words, then the sorted 64-bit SHA-1 fingerprints
+#define BREACH_INDEX_MAGIC "PWBRIDX1"
+// Bloom probes per lookup an index may ask for (the builder uses 7)
+#define BREACH_MAX_BLOOM_HASHES 32
+
+typedef struct {
+    char magic[8];
+    uint64_t count;
+    uint32_t prefixBits;
+    uint32_t bloomHashes;
+    uint64_t bloomBits;
+} BreachIndexHeader;
+
+// A mapped breach index; lookups only read the mapping
+typedef struct {
+    void *map;
+    size_t mapSize;
+    const BreachIndexHeader *header;
+    const uint64_t *prefixTable;
+    const uint64_t *bloom;
+    const uint64_t *fingerprints;
+} BreachIndex;
+
+// Audit split into newline-aligned chunks that workers claim one at a time
+// and rate into a private histogram, reduced once they finish
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t chunkSize;
+    size_t chunkCount;
+    atomic_size_t nextChunk;
+    ClassifyFunction classify;
+    AuditHistogram *histograms;
+} AuditJob;
+
+// Audit chunk size; large enough that claiming a chunk costs nothing
+#define AUDIT_CHUNK_SIZE (8 * 1024 * 1024)
+
+typedef struct RandomEngine RandomEngine;
+
+// Character set resolved once per config: lookup[b] is valid for every
+// random byte b < rejectThreshold, so no modulo or strlen in the hot loop.
+typedef struct {
+    char chars[128];
+    int size;
+    int rejectThreshold;
+    char lookup[256];
+} CompiledCharset;
+
+// Random byte source: refill() regenerates buffer[] and resets position.
+// The ChaCha20 engine is keyed once from getrandom() and then needs no syscalls.
+struct RandomEngine {
+    void (*refill)(RandomEngine *engine);
+    uint32_t key[8];
+    uint64_t counter;
+    size_t position;
+    unsigned char buffer[RANDOM_BUFFER_SIZE];
+};
 
+// Memory for generated secrets: one mapping with an inaccessible guard page
+// on each side, locked against swapping and left out of core dumps. Blocks
+// are bump allocated (safe from several threads) and never freed singly;
+// a reset wipes everything handed out with one explicit_bzero().
+typedef struct SecretArena {
+    unsigned char *map;
+    size_t mapSize;
+    unsigned char *base;
+    size_t capacity;
+    atomic_size_t used;
+    int locked;
+} SecretArena;
+
+// The interactive list; passwords point into the arena, sized to fit
 typedef struct {
-    char passwords[MAX_PASSWORDS][MAX_PASSWORD_LENGTH];
+    char *passwords[MAX_PASSWORDS];
     int count;
+    SecretArena *arena;
 } PasswordList;
 
+typedef enum {
+    FORMAT_PLAIN,
+    FORMAT_CSV,
+    FORMAT_JSONL,
+    FORMAT_BINARY
+} OutputFormat;
+
+// Where bulk output goes. With O_DIRECT every write must be whole aligned
+// blocks, so data passes through the aligned staging buffer and the
+// sub-block tail is carried over to the next write.
+typedef struct {
+    int fd;
+    int direct;
+    char *staging;
+    size_t carried;
+    unsigned long long bytesWritten;
+} OutputSink;
+
+typedef struct {
+    OutputSink *sink;
+    char *data;
+    size_t used;
+    size_t capacity;
+    int owned;
+} OutputBuffer;
+
+// A named configuration the daemon serves with GET <name>
+typedef struct {
+    char name[32];
+    PasswordConfig config;
+} DaemonProfile;
+
+typedef struct {
+    PasswordConfig config;
+    unsigned long long count;
+    const char *outputPath;
+    OutputFormat format;
+    int directIo;
+    int bulk;
+    int threads;
+    int ordered;
+    PasswordPolicy policy;
+    int usePolicy;
+    int seeded;
+    uint32_t seedKey[8];
+    unsigned long long start;
+    const char *verifyPassword;
+    const char *auditPath;
+    int noSimd;
+    const char *breachIndexPath;
+    const char *breachCorpusPath;
+    const char *wordlistPath;
+    const char *markovPath;
+    const char *markovCorpusPath;
+    const char *daemonPath;
+    DaemonProfile profiles[DAEMON_MAX_PROFILES];
+    int profileCount;
+    int unique;
+    unsigned long long uniqueMemory;
+    int menu;
+} CommandLineOptions;
+
+// Bounded concurrent set of 64-bit password fingerprints for --unique: open
+// addressing with linear probing, where a worker claims an empty (zero) slot
+// with one compare-and-swap. Fingerprints are keyed per run, so the table
+// says nothing about the passwords once the process is gone.
+typedef struct {
+    _Atomic uint64_t *slots;
+    uint64_t mask;
+    uint64_t key[2];
+    unsigned long long limit;
+    atomic_ullong used;
+} FingerprintSet;
+
+// Redraws allowed for one password before --unique gives up on the space,
+// while the space is nearly empty; the limit grows with the expected draws
+// per new password as the space fills
+#define UNIQUE_MAX_ATTEMPTS 1000
+
+// Draws allowed for one password before every candidate is taken to be in
+// the breach index and generation fails with EAGAIN
+#define BREACH_MAX_ATTEMPTS 1000
+
+// Passwords whose set probes are issued together in --unique mode
+#define UNIQUE_BATCH 16
+
+// Default --unique-memory, in MiB
+#define UNIQUE_DEFAULT_MEMORY 1024
+
+// Shared state of one bulk run. Workers claim chunks of passwordsPerChunk
+// passwords and fill their own buffer, then park it in ready[chunk % slots].
+// Whoever finds no write in progress becomes the writer and sends every
+// parked buffer it may (in ordered mode: the consecutive run starting at
+// nextChunkToWrite) in a single writev(). In unordered mode a worker can get
+// a full round of chunks ahead of one still parked, so it waits for its slot
+// to be written before parking in it. nextChunkToWrite counts the chunks
+// written, which the run checks against chunkCount at the end.
+typedef struct {
+    const CommandLineOptions *options;
+    const CompiledCharset *charset;
+    OutputSink *sink;
+    SecretArena *arena;
+    FingerprintSet *unique;
+    // Distinct passwords of the configuration, 0 if not counted
+    unsigned long long space;
+    atomic_ullong duplicates;
+    unsigned long long passwordsPerChunk;
+    unsigned long long chunkCount;
+    atomic_ullong nextChunk;
+    unsigned long long nextChunkToWrite;
+    struct iovec *ready;
+    char *readyFlags;
+    int slots;
+    int writerActive;
+    int failed;
+    int error;
+    int exhausted;
+    int breached;
+    pthread_mutex_t writeLock;
+    pthread_cond_t writeTurn;
+} BulkJob;
+
+// Pre-generated passwords of one daemon profile. The refill thread is the
+// only producer (advances tail), the event loop the only consumer (advances
+// head), so the ring needs no lock. The indices live on separate cache lines.
+typedef struct {
+    char (*slots)[MAX_PASSWORD_LENGTH];
+    CompiledCharset charset;
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    _Alignas(64) unsigned long long served;
+    unsigned long long generatedInline;
+} PasswordRing;
+
+// One daemon connection: a partial request line and unsent response bytes
+typedef struct {
+    int fd;
+    char input[DAEMON_LINE_LIMIT];
+    size_t inputUsed;
+    char *output;
+    size_t outputUsed;
+    size_t outputSent;
+    size_t outputCapacity;
+    int closing;
+} DaemonClient;
+
+typedef struct {
+    DaemonProfile profiles[DAEMON_MAX_PROFILES + 1];
+    PasswordRing rings[DAEMON_MAX_PROFILES + 1];
+    int profileCount;
+    int refillEvent;
+    atomic_int stopping;
+    SecretArena arena;
+    RandomEngine *refillEngine;
+    RandomEngine *inlineEngine;
+} DaemonState;
+
 // Function prototypes
 void clearScreen();
 void displayMainMenu();
 void displayCharacterMenu();
 void displaySettingsMenu();
 void generatePassword(char *password, PasswordConfig config);
+int generateConfiguredPassword(char *password, const PasswordConfig *config, const CompiledCharset *charset,
+                               const PasswordPolicy *policy, RandomEngine *engine);
+void compileCharset(CompiledCharset *charset, const PasswordConfig *config);
+void generatePasswordCompiled(char *password, int length, const CompiledCharset *charset, RandomEngine *engine);
+void generatePasswordWithPolicy(char *password, int length, const CompiledCharset *charset,
+                                const PasswordPolicy *policy, RandomEngine *engine);
+void generatePasswordAt(char *password, int length, const CompiledCharset *charset,
+                        const uint32_t key[8], uint64_t index, uint32_t attempt);
+void sha1(const void *data, size_t size, unsigned char digest[20]);
+int openBreachIndex(BreachIndex *index, const char *path);
+void closeBreachIndex(BreachIndex *index);
+int breachIndexContains(const BreachIndex *index, const char *password, size_t length);
+int passwordIsBreached(const char *password, size_t length);
+int openWordlist(Wordlist *wordlist, const char *path);
+void closeWordlist(Wordlist *wordlist);
+int generatePassphrase(char *password, const Wordlist *wordlist, int wordCount, char separator,
+                       RandomEngine *engine);
+int openMarkovModel(MarkovModel *model, const char *path);
+void closeMarkovModel(MarkovModel *model);
+void generatePronounceable(char *password, int length, const MarkovModel *model, int capitalize,
+                           RandomEngine *engine);
+int initChaChaEngine(RandomEngine *engine);
+void initRandEngine(RandomEngine *engine);
+RandomEngine *getDefaultRandomEngine(void);
+int initSecretArena(SecretArena *arena, size_t capacity);
+void *arenaAlloc(SecretArena *arena, size_t size, size_t alignment);
+char *arenaCopy(SecretArena *arena, const char *text, size_t length);
+void resetSecretArena(SecretArena *arena);
+void destroySecretArena(SecretArena *arena);
 void displayPasswords(PasswordList *list);
-void savePasswordsToFile(PasswordList *list);
+void savePasswordsToFile(PasswordList *list, const char *path, int format);
 void showPasswordStrength(const char *password);
+int classifyScalar(const unsigned char *text, size_t len);
+PasswordStrength evaluateStrength(size_t length, int classes);
+ClassifyFunction selectClassifier(int allowSimd);
+void auditBuffer(const char *data, size_t size, ClassifyFunction classify, AuditHistogram *histogram);
 int getValidatedInput(int min, int max);
 void getUserSettings(PasswordConfig *config);
+int openOutputSink(OutputSink *sink, const char *path, int direct);
+int sinkWritev(OutputSink *sink, const struct iovec *iov, int count);
+int closeOutputSink(OutputSink *sink);
+int initOutputBuffer(OutputBuffer *out, OutputSink *sink, SecretArena *arena);
+int flushOutputBuffer(OutputBuffer *out);
+void freeOutputBuffer(OutputBuffer *out);
+size_t formatRecord(char *dest, OutputFormat format, unsigned long long index, const char *password, int length);
+int runBulkGeneration(const CommandLineOptions *options);
+int parseCommandLine(int argc, char *argv[], CommandLineOptions *options);
+int runVerify(const CommandLineOptions *options);
+int runAudit(const CommandLineOptions *options);
+int buildBreachIndex(const char *corpusPath, const char *indexPath);
+int trainMarkovModel(const char *corpusPath, const char *modelPath);
+int runDaemon(const CommandLineOptions *options);
+int initFingerprintSet(FingerprintSet *set, unsigned long long expected, size_t maxBytes);
+void freeFingerprintSet(FingerprintSet *set);
+uint64_t fingerprintPassword(const FingerprintSet *set, const char *password, size_t length);
+int fingerprintSetInsert(FingerprintSet *set, uint64_t fingerprint);
+static int parseNumber(const char *text, unsigned long long *value);
+
+// Wordlist used by passphrase mode, if one was loaded
+static Wordlist loadedWordlist;
+static const Wordlist *activeWordlist = NULL;
+
+// Letter model used by pronounceable mode, if one was loaded
+static MarkovModel loadedMarkovModel;
+static const MarkovModel *activeMarkovModel = NULL;
 
-// Clear screen for better UX
+// Clear screen for better UX: cursor home, then erase the display. An
+// escape sequence instead of system("clear"), so a redraw starts no process.
 void clearScreen() {
-    #ifdef _WIN32
-        system("cls");
-    #else
-        system("clear");
-    #endif
+    fputs("\033[H\033[2J", stdout);
+    fflush(stdout);
+}
+
+// Display fancy separator
+void printSeparator() {
+    printf("\n");
+    for (int i = 0; i < 50; i++) printf("═");
+    printf("\n\n");
+}
+
+// Main menu
+void displayMainMenu() {
+    clearScreen();
+    printf("\n");
+    printf("    ╔════════════════════════════════════════════╗\n");
+    printf("    ║    🔐 PASSWORD GENERATOR v1.0              ║\n");
+    printf("    ╚════════════════════════════════════════════╝\n");
+    printSeparator();
+    printf("  1. ⚡ Generate Passwords (Quick)\n");
+    printf("  2. ⚙️  Configure Settings\n");
+    printf("  3. 💾 Save Passwords to File\n");
+    printf("  4. ℹ️  About This App\n");
+    printf("  5. 🚪 Exit\n");
+    printSeparator();
+    printf("  Enter your choice (1-5): ");
+}
+
+// Character selection menu
+void displayCharacterMenu() {
+    printf("\n");
+    printf("  ╔════════════════════════════════════════════╗\n");
+    printf("  ║     SELECT CHARACTER TYPES TO INCLUDE     ║\n");
+    printf("  ╚══════���═════════════════════════════════════╝\n");
+    printSeparator();
+}
+
+// Settings menu
+void displaySettingsMenu(PasswordConfig *config) {
+    clearScreen();
+    printf("\n");
+    printf("  ╔════════════════════════════════════════════╗\n");
+    printf("  ║           PASSWORD SETTINGS               ║\n");
+    printf("  ╚════════════════════════════════════════════╝\n");
+    printSeparator();
+    printf("  Current Settings:\n");
+    printf("  • Length: %d characters\n", config->length);
+    printf("  • Lowercase: %s\n", config->useLower ? "✓ Enabled" : "✗ Disabled");
+    printf("  • Uppercase: %s\n", config->useUpper ? "✓ Enabled" : "✗ Disabled");
+    printf("  • Digits: %s\n", config->useDigits ? "✓ Enabled" : "✗ Disabled");
+    printf("  • Special Characters: %s\n", config->useSpecial ? "✓ Enabled" : "✗ Disabled");
+    if (config->mode == PASSWORD_MODE_PASSPHRASE) {
+        printf("  • Mode: Passphrase (%d words from %u)\n", config->wordCount, activeWordlist->count);
+    } else if (config->mode == PASSWORD_MODE_PRONOUNCEABLE) {
+        printf("  • Mode: Pronounceable (letters only)\n");
+    } else {
+        printf("  • Mode: Random characters\n");
+    }
+    printSeparator();
+    printf("  1. Change Password Length\n");
+    printf("  2. Toggle Character Types\n");
+    printf("  3. Reset to Default\n");
+    printf("  4. Switch Mode (random, passphrase, pronounceable)\n");
+    printf("  5. Back to Main Menu\n");
+    printSeparator();
+    printf("  Enter your choice (1-5): ");
+}
+
+// Get validated integer input
+int getValidatedInput(int min, int max) {
+    int choice;
+    int c;
+    while (scanf("%d", &choice) != 1 || choice < min || choice > max) {
+        if (feof(stdin)) {
+            // Input was closed (piped or scripted); nothing more will come
+            printf("\n");
+            exit(0);
+        }
+        while ((c = getchar()) != '\n' && c != EOF); // Clear input buffer
+        printf("  ❌ Invalid input! Please enter a number between %d and %d: ", min, max);
+    }
+    while ((c = getchar()) != '\n' && c != EOF); // Clear newline from buffer
+    return choice;
+}
+
+#define LOWERCASE_CHARS "abcdefghijklmnopqrstuvwxyz"
+#define UPPERCASE_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define DIGIT_CHARS "0123456789"
+#define SPECIAL_CHARS "!@#$%^&*-_+=[]{}|;:,.<>?"
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define CHACHA_QUARTER(a, b, c, d) \
+    a += b; d ^= a; d = ROTL32(d, 16); \
+    c += d; b ^= c; b = ROTL32(b, 12); \
+    a += b; d ^= a; d = ROTL32(d, 8);  \
+    c += d; b ^= c; b = ROTL32(b, 7)
+
+// Produce one 64-byte ChaCha20 block for key, 64-bit block counter and nonce
+static void chachaBlock(const uint32_t key[8], uint64_t counter, uint64_t nonce, unsigned char out[64]) {
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        (uint32_t)counter, (uint32_t)(counter >> 32),
+        (uint32_t)nonce, (uint32_t)(nonce >> 32)
+    };
+    uint32_t x[16];
+    memcpy(x, input, sizeof(x));
+
+    for (int round = 0; round < 10; round++) {
+        CHACHA_QUARTER(x[0], x[4], x[8],  x[12]);
+        CHACHA_QUARTER(x[1], x[5], x[9],  x[13]);
+        CHACHA_QUARTER(x[2], x[6], x[10], x[14]);
+        CHACHA_QUARTER(x[3], x[7], x[11], x[15]);
+        CHACHA_QUARTER(x[0], x[5], x[10], x[15]);
+        CHACHA_QUARTER(x[1], x[6], x[11], x[12]);
+        CHACHA_QUARTER(x[2], x[7], x[8],  x[13]);
+        CHACHA_QUARTER(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        uint32_t v = x[i] + input[i];
+        out[4 * i] = (unsigned char)v;
+        out[4 * i + 1] = (unsigned char)(v >> 8);
+        out[4 * i + 2] = (unsigned char)(v >> 16);
+        out[4 * i + 3] = (unsigned char)(v >> 24);
+    }
+}
+
+// Read seed material from the kernel
+static int readSystemEntropy(void *buffer, size_t size) {
+    unsigned char *p = buffer;
+    while (size > 0) {
+        ssize_t got = getrandom(p, size, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += got;
+        size -= (size_t)got;
+    }
+    return 0;
+}
+
+// Regenerate the buffer; its first 32 bytes become the next key and are
+// wiped, so a later memory dump can't reconstruct earlier output
+static void refillChaChaEngine(RandomEngine *engine) {
+    for (size_t offset = 0; offset < RANDOM_BUFFER_SIZE; offset += 64) {
+        chachaBlock(engine->key, engine->counter++, 0, engine->buffer + offset);
+    }
+    memcpy(engine->key, engine->buffer, sizeof(engine->key));
+    memset(engine->buffer, 0, sizeof(engine->key));
+    engine->counter = 0;
+    engine->position = sizeof(engine->key);
+}
+
+// Key a ChaCha20 engine with one getrandom() call
+int initChaChaEngine(RandomEngine *engine) {
+    if (readSystemEntropy(engine->key, sizeof(engine->key)) != 0) {
+        return -1;
+    }
+    engine->counter = 0;
+    engine->refill = refillChaChaEngine;
+    engine->refill(engine);
+    return 0;
+}
+
+// rand() only guarantees 15 random bits, glibc gives 31
+#define RAND_BYTES_PER_CALL (RAND_MAX >= 0xFFFFFF ? 3 : 1)
+
+// Refill from the C library rand(); not secure, kept for benchmark comparisons
+static void refillRandEngine(RandomEngine *engine) {
+    size_t i = 0;
+    while (i < RANDOM_BUFFER_SIZE) {
+        unsigned int r = (unsigned int)rand();
+        for (int b = 0; b < RAND_BYTES_PER_CALL && i < RANDOM_BUFFER_SIZE; b++) {
+            engine->buffer[i++] = (unsigned char)(r & 0xFF);
+            r >>= 8;
+        }
+    }
+    engine->position = 0;
+}
+
+// Set up an engine backed by rand()
+void initRandEngine(RandomEngine *engine) {
+    memset(engine->key, 0, sizeof(engine->key));
+    engine->counter = 0;
+    engine->refill = refillRandEngine;
+    engine->refill(engine);
+}
+
+// Map a guarded, locked arena of at least capacity bytes. If the memlock
+// limit is too low the soft limit is raised as far as allowed; failing
+// that the arena still works, unlocked, after a warning.
+int initSecretArena(SecretArena *arena, size_t capacity) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    capacity = (capacity + page - 1) / page * page;
+    arena->mapSize = capacity + 2 * page;
+    arena->map = mmap(NULL, arena->mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena->map == MAP_FAILED) {
+        arena->map = NULL;
+        return -1;
+    }
+    if (mprotect(arena->map, page, PROT_NONE) != 0 ||
+        mprotect(arena->map + page + capacity, page, PROT_NONE) != 0) {
+        munmap(arena->map, arena->mapSize);
+        arena->map = NULL;
+        return -1;
+    }
+    arena->base = arena->map + page;
+    arena->capacity = capacity;
+    atomic_init(&arena->used, 0);
+    madvise(arena->base, capacity, MADV_DONTDUMP);
+
+    arena->locked = mlock(arena->base, capacity) == 0;
+    if (!arena->locked) {
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            if (setrlimit(RLIMIT_MEMLOCK, &limit) == 0) {
+                arena->locked = mlock(arena->base, capacity) == 0;
+            }
+        }
+    }
+    if (!arena->locked) {
+        fprintf(stderr, "Warning: could not lock %zu KiB of password memory (%s); it may be swapped out\n",
+                capacity / 1024, strerror(errno));
+    }
+    return 0;
+}
+
+// Hand out size bytes at the given power-of-two alignment, or NULL when full
+void *arenaAlloc(SecretArena *arena, size_t size, size_t alignment) {
+    size_t used = atomic_load_explicit(&arena->used, memory_order_relaxed);
+    size_t start;
+    do {
+        start = (used + alignment - 1) & ~(alignment - 1);
+        if (start > arena->capacity || arena->capacity - start < size) return NULL;
+    } while (!atomic_compare_exchange_weak_explicit(&arena->used, &used, start + size,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return arena->base + start;
+}
+
+// Copy a password into the arena as a NUL-terminated string
+char *arenaCopy(SecretArena *arena, const char *text, size_t length) {
+    char *copy = arenaAlloc(arena, length + 1, 1);
+    if (copy != NULL) {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// Wipe everything allocated so far and start over; no block may be in use
+void resetSecretArena(SecretArena *arena) {
+    size_t used = atomic_load(&arena->used);
+    explicit_bzero(arena->base, used < arena->capacity ? used : arena->capacity);
+    atomic_store(&arena->used, 0);
+}
+
+// Wipe, unlock and unmap an arena
+void destroySecretArena(SecretArena *arena) {
+    if (arena->map == NULL) return;
+    resetSecretArena(arena);
+    if (arena->locked) munlock(arena->base, arena->capacity);
+    munmap(arena->map, arena->mapSize);
+    arena->map = NULL;
+}
+
+// Process-wide ChaCha20 engine for callers that don't manage their own. It
+// lives in its own arena, since its buffer holds upcoming password material.
+RandomEngine *getDefaultRandomEngine(void) {
+    static SecretArena arena;
+    static RandomEngine *engine = NULL;
+    if (engine == NULL) {
+        if (initSecretArena(&arena, sizeof(RandomEngine)) != 0 ||
+            (engine = arenaAlloc(&arena, sizeof(RandomEngine), 64)) == NULL ||
+            initChaChaEngine(engine) != 0) {
+            fprintf(stderr, "Error: could not seed random generator: %s\n", strerror(errno));
+            exit(1);
+        }
+    }
+    return engine;
+}
+
+// Build the flat character table and rejection threshold for a config
+void compileCharset(CompiledCharset *charset, const PasswordConfig *config) {
+    int size = 0;
+    const char *classes[4] = {
+        config->useLower ? LOWERCASE_CHARS : "",
+        config->useUpper ? UPPERCASE_CHARS : "",
+        config->useDigits ? DIGIT_CHARS : "",
+        config->useSpecial ? SPECIAL_CHARS : ""
+    };
+
+    for (int c = 0; c < 4; c++) {
+        for (const char *p = classes[c]; *p; p++) {
+            charset->chars[size++] = *p;
+        }
+    }
+    charset->chars[size] = '\0';
+    charset->size = size;
+
+    // Largest multiple of size that fits in a byte; bytes at or above it
+    // are redrawn so every character is equally likely
+    charset->rejectThreshold = size > 0 ? 256 - (256 % size) : 0;
+    for (int b = 0; b < 256; b++) {
+        charset->lookup[b] = size > 0 ? charset->chars[b % size] : '\0';
+    }
+}
+
+// Generate a password from a precompiled charset. Rejection is a
+// conditional increment rather than a branch: every byte is stored, and the
+// position only advances past the ones below the threshold.
+void generatePasswordCompiled(char *password, int length, const CompiledCharset *charset, RandomEngine *engine) {
+    int threshold = charset->rejectThreshold;
+    int produced = 0;
+
+    while (produced < length) {
+        if (engine->position == RANDOM_BUFFER_SIZE) {
+            engine->refill(engine);
+        }
+        const unsigned char *random = engine->buffer + engine->position;
+        size_t available = RANDOM_BUFFER_SIZE - engine->position;
+        size_t used = 0;
+        while (used < available && produced < length) {
+            unsigned char b = random[used++];
+            password[produced] = charset->lookup[b];
+            produced += b < threshold;
+        }
+        engine->position += used;
+    }
+    password[length] = '\0';
+}
+
+// Generate password number index of the stream identified by key. Each
+// index is its own ChaCha20 nonce, so any password can be produced directly
+// without generating the ones before it. attempt selects a disjoint counter
+// range, giving reproducible redraws of the same index.
+void generatePasswordAt(char *password, int length, const CompiledCharset *charset,
+                        const uint32_t key[8], uint64_t index, uint32_t attempt) {
+    unsigned char block[64];
+    int threshold = charset->rejectThreshold;
+    int produced = 0;
+
+    for (uint64_t counter = (uint64_t)attempt << 32; produced < length; counter++) {
+        chachaBlock(key, counter, index, block);
+        for (int i = 0; i < 64 && produced < length; i++) {
+            if (block[i] < threshold) {
+                password[produced++] = charset->lookup[block[i]];
+            }
+        }
+    }
+    password[length] = '\0';
+}
+
+// Uniform random number in [0, n) for n <= 256, by byte rejection
+static unsigned int randomBelow(RandomEngine *engine, unsigned int n) {
+    unsigned int threshold = 256 - 256 % n;
+    for (;;) {
+        if (engine->position == RANDOM_BUFFER_SIZE) {
+            engine->refill(engine);
+        }
+        unsigned int b = engine->buffer[engine->position++];
+        if (b < threshold) {
+            return b % n;
+        }
+    }
+}
+
+// Build a password that meets the policy by construction. Each position
+// gets a class label: the required minimum of each class, the rest "any".
+// The labels are shuffled with Fisher-Yates and each position is then
+// drawn from its class, skipping the previous character when repeats are
+// forbidden. Cost is fixed per character whatever the policy asks for.
+void generatePasswordWithPolicy(char *password, int length, const CompiledCharset *charset,
+                                const PasswordPolicy *policy, RandomEngine *engine) {
+    const char *pools[5] = {
+        LOWERCASE_CHARS, UPPERCASE_CHARS, DIGIT_CHARS, SPECIAL_CHARS, charset->chars
+    };
+    const int poolSizes[5] = {
+        sizeof(LOWERCASE_CHARS) - 1, sizeof(UPPERCASE_CHARS) - 1,
+        sizeof(DIGIT_CHARS) - 1, sizeof(SPECIAL_CHARS) - 1, charset->size
+    };
+    const int minimums[4] = {
+        policy->minLower, policy->minUpper, policy->minDigits, policy->minSpecial
+    };
+    unsigned char labels[MAX_PASSWORD_LENGTH];
+    int n = 0;
+
+    for (int c = 0; c < 4; c++) {
+        for (int k = 0; k < minimums[c]; k++) labels[n++] = (unsigned char)c;
+    }
+    while (n < length) labels[n++] = 4;
+
+    for (int i = length - 1; i > 0; i--) {
+        int j = (int)randomBelow(engine, (unsigned int)i + 1);
+        unsigned char t = labels[i];
+        labels[i] = labels[j];
+        labels[j] = t;
+    }
+
+    for (int i = 0; i < length; i++) {
+        const char *pool = pools[labels[i]];
+        int size = poolSizes[labels[i]];
+        const char *previous = (policy->noRepeats && i > 0) ? memchr(pool, password[i - 1], size) : NULL;
+
+        if (previous == NULL) {
+            password[i] = pool[randomBelow(engine, (unsigned int)size)];
+        } else {
+            // Draw from the other size - 1 characters of the pool
+            int skip = (int)(previous - pool);
+            int k = (int)randomBelow(engine, (unsigned int)size - 1);
+            password[i] = pool[k >= skip ? k + 1 : k];
+        }
+    }
+    password[length] = '\0';
+}
+
+#define ROTL32_SHA(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+// Process one 64-byte SHA-1 block
+static void sha1Block(uint32_t state[5], const unsigned char *block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 |
+               (uint32_t)block[4 * i + 2] << 8 | (uint32_t)block[4 * i + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = ROTL32_SHA(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+        else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+        else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+        uint32_t t = ROTL32_SHA(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = ROTL32_SHA(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+// SHA-1 digest of a buffer, the hash used by breach corpora such as HIBP
+void sha1(const void *data, size_t size, unsigned char digest[20]) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const unsigned char *p = data;
+    unsigned char block[64];
+    size_t remaining = size;
+
+    while (remaining >= 64) {
+        sha1Block(state, p);
+        p += 64;
+        remaining -= 64;
+    }
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, p, remaining);
+    block[remaining] = 0x80;
+    if (remaining >= 56) {
+        sha1Block(state, block);
+        memset(block, 0, sizeof(block));
+    }
+    uint64_t bits = (uint64_t)size * 8;
+    for (int i = 0; i < 8; i++) {
+        block[63 - i] = (unsigned char)(bits >> (8 * i));
+    }
+    sha1Block(state, block);
+
+    for (int i = 0; i < 5; i++) {
+        digest[4 * i] = (unsigned char)(state[i] >> 24);
+        digest[4 * i + 1] = (unsigned char)(state[i] >> 16);
+        digest[4 * i + 2] = (unsigned char)(state[i] >> 8);
+        digest[4 * i + 3] = (unsigned char)state[i];
+    }
+}
+
+// Big-endian 64-bit word from a digest, so fingerprints sort like the hex text
+static uint64_t digestWord(const unsigned char *bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value = value << 8 | bytes[i];
+    return value;
+}
+
+// Bloom filter probe positions, from digest bits the fingerprint doesn't use
+#define BLOOM_PROBE(digest, i, mask) \
+    ((digestWord((digest) + 8) + (uint64_t)(i) * (digestWord((digest) + 12) | 1)) & (mask))
+
+// Whether the prefix table splits exactly the index's fingerprints into
+// buckets: it starts at 0, never decreases and ends at count
+static int breachPrefixTableValid(const uint64_t *prefixTable, uint64_t entries, uint64_t count) {
+    if (prefixTable[0] != 0 || prefixTable[entries - 1] != count) return 0;
+    for (uint64_t i = 1; i < entries; i++) {
+        if (prefixTable[i] < prefixTable[i - 1]) return 0;
+    }
+    return 1;
+}
+
+// Map an index file built with --build-breach-index, checking its layout
+// and prefix table so lookups never leave the mapping
+int openBreachIndex(BreachIndex *index, const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if ((size_t)info.st_size < sizeof(BreachIndexHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    index->mapSize = (size_t)info.st_size;
+    index->map = mmap(NULL, index->mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index->map == MAP_FAILED) {
+        return -1;
+    }
+
+    const BreachIndexHeader *header = index->map;
+    // Each section is bounded by the file before the sizes are added up, so
+    // the sum cannot overflow
+    uint64_t words = (index->mapSize - sizeof(BreachIndexHeader)) / 8;
+    uint64_t prefixEntries = header->prefixBits <= 32 ? ((uint64_t)1 << header->prefixBits) + 1 : UINT64_MAX;
+    int valid = memcmp(header->magic, BREACH_INDEX_MAGIC, 8) == 0 && prefixEntries <= words &&
+                header->bloomBits >= 64 && (header->bloomBits & (header->bloomBits - 1)) == 0 &&
+                header->bloomBits / 64 <= words && header->count <= words &&
+                header->bloomHashes <= BREACH_MAX_BLOOM_HASHES &&
+                sizeof(BreachIndexHeader) + 8 * (prefixEntries + header->bloomBits / 64 + header->count) ==
+                    index->mapSize;
+    if (!valid ||
+        !breachPrefixTableValid((const uint64_t *)(header + 1), prefixEntries, header->count)) {
+        munmap(index->map, index->mapSize);
+        errno = EINVAL;
+        return -1;
+    }
+
+    index->header = header;
+    index->prefixTable = (const uint64_t *)(header + 1);
+    index->bloom = index->prefixTable + prefixEntries;
+    index->fingerprints = index->bloom + header->bloomBits / 64;
+    return 0;
+}
+
+// Unmap a breach index
+void closeBreachIndex(BreachIndex *index) {
+    if (index->map != NULL && index->map != MAP_FAILED) {
+        munmap(index->map, index->mapSize);
+    }
+    index->map = NULL;
+}
+
+// Is this SHA-1 digest in the index? Bloom filter first, then a binary
+// search inside the bucket picked by the fingerprint's top bits
+static int breachIndexContainsDigest(const BreachIndex *index, const unsigned char digest[20]) {
+    const BreachIndexHeader *header = index->header;
+    uint64_t mask = header->bloomBits - 1;
+
+    for (uint32_t i = 0; i < header->bloomHashes; i++) {
+        uint64_t bit = BLOOM_PROBE(digest, i, mask);
+        if (!(index->bloom[bit / 64] >> (bit % 64) & 1)) {
+            return 0;
+        }
+    }
+
+    uint64_t fingerprint = digestWord(digest);
+    uint64_t bucket = header->prefixBits ? fingerprint >> (64 - header->prefixBits) : 0;
+    uint64_t low = index->prefixTable[bucket];
+    uint64_t high = index->prefixTable[bucket + 1];
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        if (index->fingerprints[middle] < fingerprint) low = middle + 1;
+        else high = middle;
+    }
+    return low < index->prefixTable[bucket + 1] && index->fingerprints[low] == fingerprint;
+}
+
+// Is this password in the index?
+int breachIndexContains(const BreachIndex *index, const char *password, size_t length) {
+    unsigned char digest[20];
+    sha1(password, length, digest);
+    return breachIndexContainsDigest(index, digest);
+}
+
+// Index consulted by generation and strength reporting, if one was loaded
+static BreachIndex loadedBreachIndex;
+static const BreachIndex *activeBreachIndex = NULL;
+
+// Check a password against the loaded breach index, if any
+int passwordIsBreached(const char *password, size_t length) {
+    return activeBreachIndex != NULL && breachIndexContains(activeBreachIndex, password, length);
+}
+
+// Uniform random number in [0, n) from four engine bytes, by rejection
+static uint32_t randomBelow32(RandomEngine *engine, uint32_t n) {
+    uint64_t limit = ((uint64_t)1 << 32) - ((uint64_t)1 << 32) % n;
+    for (;;) {
+        if (RANDOM_BUFFER_SIZE - engine->position < 4) {
+            engine->refill(engine);
+        }
+        const unsigned char *b = engine->buffer + engine->position;
+        engine->position += 4;
+        uint32_t r = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+        if (r < limit) {
+            return r % n;
+        }
+    }
+}
+
+// Point the wordlist at an index laid out as in FILE.idx
+static void useWordlistIndex(Wordlist *wordlist, const WordlistIndexHeader *header) {
+    wordlist->count = header->count;
+    wordlist->longestWord = (int)header->longestWord;
+    wordlist->offsets = (const uint32_t *)(header + 1);
+    wordlist->lengths = (const unsigned char *)(wordlist->offsets + header->count);
+}
+
+// Scan the wordlist once into a malloc'd index laid out as in FILE.idx.
+// Accepts one word per line or EFF-style "11111<tab>word" lines (the last
+// field is the word).
+static WordlistIndexHeader *buildWordlistIndex(const char *text, size_t size, const struct stat *source,
+                                               size_t *indexSize) {
+    size_t capacity = 1024;
+    uint32_t count = 0;
+    uint32_t longest = 0;
+    uint32_t *offsets = malloc(capacity * sizeof(uint32_t));
+    unsigned char *lengths = malloc(capacity);
+    const char *p = text;
+    const char *end = text + size;
+
+    while (offsets != NULL && lengths != NULL && p < end) {
+        const char *newline = memchr(p, '\n', (size_t)(end - p));
+        const char *lineEnd = newline ? newline : end;
+        const char *wordEnd = lineEnd;
+        while (wordEnd > p && isspace((unsigned char)wordEnd[-1])) wordEnd--;
+        const char *word = wordEnd;
+        while (word > p && !isspace((unsigned char)word[-1])) word--;
+
+        size_t length = (size_t)(wordEnd - word);
+        if (length > 0 && length <= MAX_WORD_LENGTH) {
+            if (count == capacity) {
+                capacity *= 2;
+                uint32_t *grownOffsets = realloc(offsets, capacity * sizeof(uint32_t));
+                if (grownOffsets != NULL) offsets = grownOffsets;
+                unsigned char *grownLengths = realloc(lengths, capacity);
+                if (grownLengths != NULL) lengths = grownLengths;
+                if (grownOffsets == NULL || grownLengths == NULL) break;
+            }
+            offsets[count] = (uint32_t)(word - text);
+            lengths[count] = (unsigned char)length;
+            if (length > longest) longest = (uint32_t)length;
+            count++;
+        }
+        p = lineEnd + 1;
+    }
+    *indexSize = sizeof(WordlistIndexHeader) + (size_t)count * 5;
+    WordlistIndexHeader *header = offsets != NULL && lengths != NULL && p >= end ? malloc(*indexSize) : NULL;
+    if (header == NULL) {
+        free(offsets);
+        free(lengths);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, WORDLIST_INDEX_MAGIC, 8);
+    header->sourceSize = (uint64_t)source->st_size;
+    header->sourceMtimeSec = (int64_t)source->st_mtim.tv_sec;
+    header->sourceMtimeNsec = (int64_t)source->st_mtim.tv_nsec;
+    header->count = count;
+    header->longestWord = longest;
+    memcpy(header + 1, offsets, (size_t)count * sizeof(uint32_t));
+    memcpy((char *)(header + 1) + (size_t)count * sizeof(uint32_t), lengths, count);
+    free(offsets);
+    free(lengths);
+    return header;
+}
+
+// Write an index to the FILE.idx cache; returns 0, or -1 if it could not be
+// written (a read-only directory, say)
+static int writeWordlistIndex(const WordlistIndexHeader *header, size_t indexSize, const char *indexPath) {
+    // Write to a temporary name and rename, so readers never see half a file
+    char tempPath[4096 + 32];
+    snprintf(tempPath, sizeof(tempPath), "%s.%ld.tmp", indexPath, (long)getpid());
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) return -1;
+    int failed = fwrite(header, indexSize, 1, file) != 1;
+    failed = (fclose(file) != 0) || failed;
+    failed = failed || rename(tempPath, indexPath) != 0;
+    if (failed) unlink(tempPath);
+    return failed ? -1 : 0;
+}
+
+// Whether every entry of an index lies inside the text and within the
+// header's longest word, so a corrupt cache is never trusted
+static int wordlistIndexValid(const WordlistIndexHeader *header, size_t textSize) {
+    const uint32_t *offsets = (const uint32_t *)(header + 1);
+    const unsigned char *lengths = (const unsigned char *)(offsets + header->count);
+
+    if (header->count == 0 || header->longestWord > MAX_WORD_LENGTH) return 0;
+    for (uint32_t i = 0; i < header->count; i++) {
+        if (lengths[i] > header->longestWord || (uint64_t)offsets[i] + lengths[i] > textSize) return 0;
+    }
+    return 1;
+}
+
+// Map an index cache and check it belongs to this version of the list
+static int mapWordlistIndex(Wordlist *wordlist, const char *indexPath, const struct stat *source) {
+    int fd = open(indexPath, O_RDONLY);
+    struct stat info;
+    if (fd < 0) return -1;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(WordlistIndexHeader)) {
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const WordlistIndexHeader *header = map;
+    if (memcmp(header->magic, WORDLIST_INDEX_MAGIC, 8) != 0 ||
+        header->sourceSize != (uint64_t)source->st_size ||
+        header->sourceMtimeSec != (int64_t)source->st_mtim.tv_sec ||
+        header->sourceMtimeNsec != (int64_t)source->st_mtim.tv_nsec ||
+        (size_t)info.st_size != sizeof(*header) + (size_t)header->count * 5 ||
+        !wordlistIndexValid(header, wordlist->textSize)) {
+        munmap(map, (size_t)info.st_size);
+        return -1;
+    }
+
+    wordlist->indexMap = map;
+    wordlist->indexSize = (size_t)info.st_size;
+    useWordlistIndex(wordlist, header);
+    return 0;
+}
+
+// Map a wordlist, reusing FILE.idx when it is current and rebuilding it
+// otherwise. Startup never parses the list while the cache is valid; if the
+// rebuilt cache cannot be written, the in-memory index is used on its own.
+int openWordlist(Wordlist *wordlist, const char *path) {
+    memset(wordlist, 0, sizeof(*wordlist));
+    int fd = open(path, O_RDONLY);
+    struct stat source;
+    if (fd < 0 || fstat(fd, &source) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (source.st_size == 0 || (uint64_t)source.st_size > UINT32_MAX) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *text = mmap(NULL, (size_t)source.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (text == MAP_FAILED) return -1;
+    wordlist->text = text;
+    wordlist->textSize = (size_t)source.st_size;
+
+    char indexPath[4096];
+    snprintf(indexPath, sizeof(indexPath), "%s.idx", path);
+    if (mapWordlistIndex(wordlist, indexPath, &source) != 0) {
+        size_t indexSize;
+        WordlistIndexHeader *header = buildWordlistIndex(text, wordlist->textSize, &source, &indexSize);
+        if (header == NULL) {
+            closeWordlist(wordlist);
+            return -1;
+        }
+        // The cache only speeds up the next start; failing to write it is fine
+        writeWordlistIndex(header, indexSize, indexPath);
+        wordlist->indexMemory = header;
+        useWordlistIndex(wordlist, header);
+    }
+    if (wordlist->count < 2) {
+        closeWordlist(wordlist);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+// Unmap a wordlist and its index
+void closeWordlist(Wordlist *wordlist) {
+    if (wordlist->indexMap != NULL) munmap(wordlist->indexMap, wordlist->indexSize);
+    free(wordlist->indexMemory);
+    if (wordlist->text != NULL) munmap((void *)wordlist->text, wordlist->textSize);
+    memset(wordlist, 0, sizeof(*wordlist));
+}
+
+// Join wordCount uniformly chosen words with separator; returns the length
+int generatePassphrase(char *password, const Wordlist *wordlist, int wordCount, char separator,
+                       RandomEngine *engine) {
+    int length = 0;
+    for (int w = 0; w < wordCount; w++) {
+        uint32_t pick = randomBelow32(engine, wordlist->count);
+        if (w > 0) password[length++] = separator;
+        memcpy(password + length, wordlist->text + wordlist->offsets[pick], wordlist->lengths[pick]);
+        length += wordlist->lengths[pick];
+    }
+    password[length] = '\0';
+    return length;
+}
+
+// Whether every table entry names a real alias outcome and starts its next
+// rows on a context, so a corrupt model never walks outside the table
+static int markovTableValid(const uint64_t *table) {
+    const uint32_t rows = MARKOV_CONTEXTS * MARKOV_OUTCOMES;
+    for (uint32_t i = 0; i < rows; i++) {
+        uint32_t alias = (uint32_t)(table[i] >> 32) & 0xFF;
+        uint32_t aliasNext = (uint32_t)(table[i] >> 16) & 0xFFFF;
+        uint32_t columnNext = (uint32_t)table[i] & 0xFFFF;
+        if (alias >= MARKOV_OUTCOMES || aliasNext % MARKOV_OUTCOMES != 0 || aliasNext >= rows ||
+            columnNext % MARKOV_OUTCOMES != 0 || columnNext >= rows) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Map a trained letter model and check its shape and every table entry
+int openMarkovModel(MarkovModel *model, const char *path) {
+    memset(model, 0, sizeof(*model));
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    size_t expected = sizeof(MarkovModelHeader) + (size_t)MARKOV_CONTEXTS * MARKOV_OUTCOMES * sizeof(uint64_t);
+    if ((size_t)info.st_size != expected) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *map = mmap(NULL, expected, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const MarkovModelHeader *header = map;
+    if (memcmp(header->magic, MARKOV_MODEL_MAGIC, 8) != 0 ||
+        header->symbols != MARKOV_SYMBOLS || header->outcomes != MARKOV_OUTCOMES ||
+        !markovTableValid((const uint64_t *)(header + 1))) {
+        munmap(map, expected);
+        errno = EINVAL;
+        return -1;
+    }
+    model->map = map;
+    model->mapSize = expected;
+    model->header = header;
+    model->table = (const uint64_t *)(header + 1);
+    return 0;
+}
+
+// Unmap a letter model
+void closeMarkovModel(MarkovModel *model) {
+    if (model->map != NULL) munmap(model->map, model->mapSize);
+    memset(model, 0, sizeof(*model));
+}
+
+// Walk the letter model for length characters, one 16-bit draw each. The
+// top bits of draw * 52 pick the alias column and the low 16 bits, against
+// the top 16 bits of the threshold, decide between the column and its
+// alias. Two bytes a character keep the walk close to the random path,
+// which is bound by the same ChaCha20 stream; the 16-bit threshold moves
+// no outcome's chance by more than 2^-16. Word starts are capitalized on
+// request.
+void generatePronounceable(char *password, int length, const MarkovModel *model, int capitalize,
+                           RandomEngine *engine) {
+    if (RANDOM_BUFFER_SIZE - engine->position < (size_t)length * 2) {
+        engine->refill(engine);
+    }
+    const unsigned char *random = engine->buffer + engine->position;
+    engine->position += (size_t)length * 2;
+
+    const uint64_t *table = model->table;
+    uint32_t upper = capitalize ? 32 : 0;
+    uint32_t row = 0;
+    for (int i = 0; i < length; i++) {
+        const unsigned char *b = random + 2 * i;
+        uint32_t scaled = ((uint32_t)b[0] | (uint32_t)b[1] << 8) * MARKOV_OUTCOMES;
+        uint32_t column = scaled >> 16;
+        uint64_t entry = table[row + column];
+        // The accept test is a coin flip, so select with masks rather than a branch
+        uint32_t reject = (scaled & 0xFFFF) >= (uint32_t)(entry >> 48);
+        uint32_t keep = reject - 1;
+        uint32_t outcome = (column & keep) | ((uint32_t)(entry >> 32) & 0xFF & ~keep);
+        row = (uint32_t)(entry >> (reject << 4)) & 0xFFFF;
+
+        uint32_t wordStart = outcome >= 26;
+        password[i] = (char)('a' + outcome - (wordStart ? 26 + upper : 0));
+    }
+    password[length] = '\0';
+}
+
+// Generate one password for config in whatever mode it selects, redrawing
+// breached ones; policy may be NULL. Returns the password length, or -1
+// with errno EAGAIN if BREACH_MAX_ATTEMPTS draws were all breached.
+int generateConfiguredPassword(char *password, const PasswordConfig *config, const CompiledCharset *charset,
+                               const PasswordPolicy *policy, RandomEngine *engine) {
+    int length = config->length;
+    int attempts = 0;
+    do {
+        if (attempts++ == BREACH_MAX_ATTEMPTS) {
+            explicit_bzero(password, MAX_PASSWORD_LENGTH);
+            errno = EAGAIN;
+            return -1;
+        }
+        if (config->mode == PASSWORD_MODE_PASSPHRASE && activeWordlist != NULL) {
+            length = generatePassphrase(password, activeWordlist, config->wordCount, config->separator, engine);
+        } else if (config->mode == PASSWORD_MODE_PRONOUNCEABLE && activeMarkovModel != NULL) {
+            generatePronounceable(password, length, activeMarkovModel, config->useUpper, engine);
+        } else if (policy != NULL) {
+            generatePasswordWithPolicy(password, length, charset, policy, engine);
+        } else {
+            generatePasswordCompiled(password, length, charset, engine);
+        }
+    } while (passwordIsBreached(password, (size_t)length));
+    return length;
+}
+
+// Generate a single password
+void generatePassword(char *password, PasswordConfig config) {
+    CompiledCharset charset;
+    compileCharset(&charset, &config);
+    if (generateConfiguredPassword(password, &config, &charset, NULL, getDefaultRandomEngine()) < 0) {
+        password[0] = '\0';
+    }
+}
+
+// Check a library caller's config the way parseCommandLine() checks flags;
+// returns the longest password it can produce, or 0 if it is unusable
+static int batchPasswordLimit(const PasswordConfig *config, const PasswordPolicy *policy) {
+    if (config->mode == PASSWORD_MODE_PASSPHRASE) {
+        if (activeWordlist == NULL || policy != NULL || config->wordCount < 1 ||
+            config->wordCount * (activeWordlist->longestWord + 1) > MAX_PASSWORD_LENGTH) return 0;
+        return MAX_PASSWORD_LENGTH - 1;
+    }
+    if (config->length < 1 || config->length >= MAX_PASSWORD_LENGTH) return 0;
+    if (config->mode == PASSWORD_MODE_PRONOUNCEABLE) {
+        return (activeMarkovModel != NULL && policy == NULL) ? config->length : 0;
+    }
+    if (config->mode != PASSWORD_MODE_RANDOM ||
+        !(config->useLower || config->useUpper || config->useDigits || config->useSpecial)) return 0;
+    if (policy != NULL &&
+        ((policy->minLower && !config->useLower) || (policy->minUpper && !config->useUpper) ||
+         (policy->minDigits && !config->useDigits) || (policy->minSpecial && !config->useSpecial) ||
+         policy->minLower < 0 || policy->minUpper < 0 || policy->minDigits < 0 || policy->minSpecial < 0 ||
+         policy->minLower + policy->minUpper + policy->minDigits + policy->minSpecial > config->length)) return 0;
+    return config->length;
+}
+
+// Generate count passwords into a fresh secret arena: the pointer and length
+// tables, a private engine, then each password at its real length
+int generatePasswordBatch(const PasswordConfig *config, const PasswordPolicy *policy,
+                          size_t count, PasswordBatch *batch) {
+    memset(batch, 0, sizeof(*batch));
+    int longest = batchPasswordLimit(config, policy);
+    if (longest == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count == 0) return 0;
+
+    size_t perPassword = sizeof(char *) + sizeof(int) + (size_t)longest + 1;
+    size_t fixed = sizeof(RandomEngine) + 2 * 64 + MAX_PASSWORD_LENGTH;
+    if (count > (SIZE_MAX - fixed) / perPassword) {
+        errno = ENOMEM;
+        return -1;
+    }
+    SecretArena *arena = malloc(sizeof(SecretArena));
+    if (arena == NULL) return -1;
+    if (initSecretArena(arena, fixed + count * perPassword) != 0) {
+        free(arena);
+        return -1;
+    }
+
+    RandomEngine *engine = arenaAlloc(arena, sizeof(RandomEngine), 64);
+    char *scratch = arenaAlloc(arena, MAX_PASSWORD_LENGTH, 1);
+    batch->passwords = arenaAlloc(arena, count * sizeof(char *), sizeof(char *));
+    batch->lengths = arenaAlloc(arena, count * sizeof(int), sizeof(int));
+    batch->memory = arena;
+    if (initChaChaEngine(engine) != 0) {
+        int error = errno;
+        freePasswordBatch(batch);
+        errno = error;
+        return -1;
+    }
+
+    CompiledCharset charset;
+    compileCharset(&charset, config);
+    for (size_t i = 0; i < count; i++) {
+        int length = generateConfiguredPassword(scratch, config, &charset, policy, engine);
+        if (length < 0) {
+            freePasswordBatch(batch);
+            errno = EAGAIN;
+            return -1;
+        }
+        batch->passwords[i] = arenaCopy(arena, scratch, (size_t)length);
+        batch->lengths[i] = length;
+    }
+    batch->count = count;
+    // The engine's buffer holds unused key stream; don't leave it behind
+    explicit_bzero(engine, sizeof(RandomEngine));
+    explicit_bzero(scratch, MAX_PASSWORD_LENGTH);
+    return 0;
+}
+
+// Wipe and release a batch; safe on an empty or already freed batch
+void freePasswordBatch(PasswordBatch *batch) {
+    if (batch->memory != NULL) {
+        destroySecretArena(batch->memory);
+        free(batch->memory);
+    }
+    memset(batch, 0, sizeof(*batch));
+}
+
+// Reject passwords found in the breach index at path from now on
+int loadBreachIndex(const char *path) {
+    BreachIndex index;
+    if (openBreachIndex(&index, path) != 0) return -1;
+    if (activeBreachIndex != NULL) closeBreachIndex(&loadedBreachIndex);
+    loadedBreachIndex = index;
+    activeBreachIndex = &loadedBreachIndex;
+    return 0;
+}
+
+// Make path the wordlist of passphrase mode, replacing any loaded one
+int loadWordlist(const char *path) {
+    Wordlist wordlist;
+    if (openWordlist(&wordlist, path) != 0) return -1;
+    if (activeWordlist != NULL) closeWordlist(&loadedWordlist);
+    loadedWordlist = wordlist;
+    activeWordlist = &loadedWordlist;
+    return 0;
+}
+
+// Make path the letter model of pronounceable mode, replacing any loaded one
+int loadMarkovModel(const char *path) {
+    MarkovModel model;
+    if (openMarkovModel(&model, path) != 0) return -1;
+    if (activeMarkovModel != NULL) closeMarkovModel(&loadedMarkovModel);
+    loadedMarkovModel = model;
+    activeMarkovModel = &loadedMarkovModel;
+    return 0;
+}
+
+// Character classes of a byte run, with the same meaning as the ctype
+// checks in the C locale: anything that isn't a letter or digit is special
+int classifyScalar(const unsigned char *text, size_t len) {
+    int classes = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = text[i];
+        if (c >= 'a' && c <= 'z') classes |= CLASS_LOWER;
+        else if (c >= 'A' && c <= 'Z') classes |= CLASS_UPPER;
+        else if (c >= '0' && c <= '9') classes |= CLASS_DIGIT;
+        else classes |= CLASS_SPECIAL;
+    }
+    return classes;
+}
+
+#ifdef HAVE_X86_SIMD
+// Byte-range tests: shifting the range start to -128 turns lo <= c <= hi into
+// one signed compare, c + (0x80 - lo) < -128 + (hi - lo + 1)
+#define RANGE_MASK_SSE(v, lo, hi) \
+    _mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - (lo)))), \
+                                     _mm_set1_epi8((char)(-128 + ((hi) - (lo) + 1)))))
+#define RANGE_MASK_AVX2(v, lo, hi) \
+    (unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8( \
+        _mm256_set1_epi8((char)(-128 + ((hi) - (lo) + 1))), \
+        _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - (lo))))))
+
+// Class bits from per-byte masks limited to the bytes that belong to the line
+static inline int classesFromMasks(unsigned int lower, unsigned int upper, unsigned int digit, unsigned int valid) {
+    lower &= valid;
+    upper &= valid;
+    digit &= valid;
+    return (lower ? CLASS_LOWER : 0) | (upper ? CLASS_UPPER : 0) | (digit ? CLASS_DIGIT : 0) |
+           ((valid & ~(lower | upper | digit)) ? CLASS_SPECIAL : 0);
+}
+
+// 16 bytes per step; the tail is copied into a zeroed block and masked off
+static int classifySse2(const unsigned char *text, size_t len) {
+    int classes = 0;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(text + i));
+        classes |= classesFromMasks(RANGE_MASK_SSE(v, 'a', 'z'), RANGE_MASK_SSE(v, 'A', 'Z'),
+                                    RANGE_MASK_SSE(v, '0', '9'), 0xFFFF);
+    }
+    if (i < len) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, text + i, len - i);
+        __m128i v = _mm_loadu_si128((const __m128i *)tail);
+        classes |= classesFromMasks(RANGE_MASK_SSE(v, 'a', 'z'), RANGE_MASK_SSE(v, 'A', 'Z'),
+                                    RANGE_MASK_SSE(v, '0', '9'), (1u << (len - i)) - 1);
+    }
+    return classes;
+}
+
+// 32 bytes per step, same scheme as the SSE2 version
+__attribute__((target("avx2")))
+static int classifyAvx2(const unsigned char *text, size_t len) {
+    int classes = 0;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(text + i));
+        classes |= classesFromMasks(RANGE_MASK_AVX2(v, 'a', 'z'), RANGE_MASK_AVX2(v, 'A', 'Z'),
+                                    RANGE_MASK_AVX2(v, '0', '9'), 0xFFFFFFFFu);
+    }
+    if (i < len) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, text + i, len - i);
+        __m256i v = _mm256_loadu_si256((const __m256i *)tail);
+        classes |= classesFromMasks(RANGE_MASK_AVX2(v, 'a', 'z'), RANGE_MASK_AVX2(v, 'A', 'Z'),
+                                    RANGE_MASK_AVX2(v, '0', '9'), (unsigned int)((1ull << (len - i)) - 1));
+    }
+    return classes;
+}
+#endif
+
+// Best classifier this CPU supports
+ClassifyFunction selectClassifier(int allowSimd) {
+#ifdef HAVE_X86_SIMD
+    if (allowSimd) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return classifyAvx2;
+        if (__builtin_cpu_supports("sse2")) return classifySse2;
+    }
+#else
+    (void)allowSimd;
+#endif
+    return classifyScalar;
+}
+
+// Strength rating from length and character classes
+PasswordStrength evaluateStrength(size_t length, int classes) {
+    int strength = ((classes & CLASS_LOWER) ? 1 : 0) + ((classes & CLASS_UPPER) ? 1 : 0) +
+                   ((classes & CLASS_DIGIT) ? 1 : 0) + ((classes & CLASS_SPECIAL) ? 1 : 0);
+
+    if (length < 8) return STRENGTH_TOO_SHORT;
+    if (strength == 4 && length >= 12) return STRENGTH_VERY_STRONG;
+    if (strength == 4 || length >= 12) return STRENGTH_STRONG;
+    if (strength >= 2) return STRENGTH_MEDIUM;
+    return STRENGTH_WEAK;
+}
+
+static const char *strengthLabels[STRENGTH_BUCKETS] = {
+    "🔴 Weak (too short)", "🔴 Weak", "🟡 Medium", "🟢 Strong", "🟢 Very Strong"
+};
+
+// Evaluate password strength
+void showPasswordStrength(const char *password) {
+    size_t length = strlen(password);
+    int classes = classifyScalar((const unsigned char *)password, length);
+
+    printf("  Strength: %s\n", strengthLabels[evaluateStrength(length, classes)]);
+    if (passwordIsBreached(password, length)) {
+        printf("  ⚠️  Found in the breach corpus - do not use!\n");
+    }
+}
+
+// Rate every newline-separated password in data; empty lines are skipped
+// and a trailing '\r' is dropped so CRLF exports rate the same
+void auditBuffer(const char *data, size_t size, ClassifyFunction classify, AuditHistogram *histogram) {
+    const char *p = data;
+    const char *end = data + size;
+
+    while (p < end) {
+        const char *newline = memchr(p, '\n', (size_t)(end - p));
+        const char *lineEnd = newline ? newline : end;
+        size_t length = (size_t)(lineEnd - p);
+        if (length > 0 && p[length - 1] == '\r') length--;
+
+        if (length > 0) {
+            int classes = classify((const unsigned char *)p, length);
+            histogram->buckets[evaluateStrength(length, classes)]++;
+            histogram->lines++;
+            histogram->breached += passwordIsBreached(p, length);
+        }
+        p = lineEnd + 1;
+    }
+    histogram->bytes += size;
+}
+
+// Display generated passwords
+void displayPasswords(PasswordList *list) {
+    if (list->count == 0) {
+        printf("  ❌ No passwords generated yet!\n");
+        return;
+    }
+    
+    printf("\n  ╔════════════════════════════════════════════╗\n");
+    printf("  ║        GENERATED PASSWORDS (%d)            ║\n", list->count);
+    printf("  ╚════════════════════════════════════════════╝\n");
+    printSeparator();
+    
+    for (int i = 0; i < list->count; i++) {
+        printf("  Password %d: %s\n", i + 1, list->passwords[i]);
+        showPasswordStrength(list->passwords[i]);
+        printf("\n");
+    }
+}
+
+// Get user settings
+void getUserSettings(PasswordConfig *config) {
+    displayCharacterMenu();
+    
+    printf("  Include lowercase letters (a-z)? (1/0): ");
+    config->useLower = getValidatedInput(0, 1);
+    
+    printf("  Include uppercase letters (A-Z)? (1/0): ");
+    config->useUpper = getValidatedInput(0, 1);
+    
+    printf("  Include digits (0-9)? (1/0): ");
+    config->useDigits = getValidatedInput(0, 1);
+    
+    printf("  Include special characters (!@#$%%)? (1/0): ");
+    config->useSpecial = getValidatedInput(0, 1);
+    
+    if (!config->useLower && !config->useUpper && !config->useDigits && !config->useSpecial) {
+        printf("\n  ⚠️  Warning: Select at least one character type!\n");
+        printf("  Using default: Uppercase + Lowercase + Digits\n");
+        config->useLower = 1;
+        config->useUpper = 1;
+        config->useDigits = 1;
+    }
+    
+    printf("\n  ✓ Settings updated!\n");
+}
+
+static const char *formatNames[] = {"plain", "csv", "jsonl", "binary"};
+
+// Save passwords to file: format -1 is the human-readable report with a
+// banner, otherwise one of the bulk output formats
+void savePasswordsToFile(PasswordList *list, const char *path, int format) {
+    if (list->count == 0) {
+        printf("\n  ❌ No passwords to save!\n");
+        return;
+    }
+    
+    if (format >= 0) {
+        OutputSink sink;
+        OutputBuffer out;
+        if (openOutputSink(&sink, path, 0) != 0) {
+            printf("\n  ❌ Error: Could not create file!\n");
+            return;
+        }
+        int failed = initOutputBuffer(&out, &sink, NULL) != 0;
+        if (!failed && format == FORMAT_CSV) {
+            memcpy(out.data, "index,length,password\n", 22);
+            out.used = 22;
+        }
+        for (int i = 0; !failed && i < list->count; i++) {
+            out.used += formatRecord(out.data + out.used, (OutputFormat)format, (unsigned long long)i + 1,
+                                     list->passwords[i], (int)strlen(list->passwords[i]));
+        }
+        if (!failed) {
+            failed = flushOutputBuffer(&out) != 0;
+        }
+        freeOutputBuffer(&out);
+        failed = closeOutputSink(&sink) != 0 || failed;
+        if (failed) {
+            printf("\n  ❌ Error: Could not write file!\n");
+        } else {
+            printf("\n  ✓ Passwords saved to '%s' (%s)\n", path, formatNames[format]);
+        }
+        return;
+    }
+    
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("\n  ❌ Error: Could not create file!\n");
+        return;
+    }
+    
+    fprintf(file, "═══════════════════════════════════════════\n");
+    fprintf(file, "       PASSWORD GENERATOR - OUTPUT\n");
+    fprintf(file, "═══════════════════════════════════════════\n\n");
+    
+    for (int i = 0; i < list->count; i++) {
+        fprintf(file, "Password %d: %s\n", i + 1, list->passwords[i]);
+    }
+    
+    fprintf(file, "\n═══════════════════════════════════════════\n");
+    fprintf(file, "Generated on: ");
+    time_t now = time(NULL);
+    fprintf(file, "%s", ctime(&now));
+    
+    fclose(file);
+    printf("\n  ✓ Passwords saved to '%s'\n", path);
+}
+
+// Open the output ("-" or NULL means stdout), optionally with O_DIRECT
+int openOutputSink(OutputSink *sink, const char *path, int direct) {
+    sink->direct = 0;
+    sink->staging = NULL;
+    sink->carried = 0;
+    sink->bytesWritten = 0;
+
+    if (path == NULL || strcmp(path, "-") == 0) {
+        sink->fd = STDOUT_FILENO;
+        return 0;
+    }
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (direct) {
+#ifdef O_DIRECT
+        sink->fd = open(path, flags | O_DIRECT, 0600);
+        if (sink->fd >= 0) {
+            if (posix_memalign((void **)&sink->staging, OUTPUT_ALIGNMENT,
+                               OUTPUT_BUFFER_SIZE + OUTPUT_ALIGNMENT) != 0) {
+                close(sink->fd);
+                errno = ENOMEM;
+                return -1;
+            }
+            sink->direct = 1;
+            return 0;
+        }
+#endif
+        // Filesystems such as tmpfs refuse O_DIRECT; fall back to buffered writes
+    }
+    sink->fd = open(path, flags, 0600);
+    return sink->fd < 0 ? -1 : 0;
+}
+
+// write() everything in buf, retrying short writes
+static int writeAll(int fd, const char *buf, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, buf, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+// Send count buffers to the sink, in order, with as few syscalls as possible
+int sinkWritev(OutputSink *sink, const struct iovec *iov, int count) {
+    if (sink->direct) {
+        // Stage into the aligned buffer and write whole blocks only
+        for (int i = 0; i < count; i++) {
+            const char *data = iov[i].iov_base;
+            size_t remaining = iov[i].iov_len;
+            while (remaining > 0) {
+                size_t take = OUTPUT_BUFFER_SIZE + OUTPUT_ALIGNMENT - sink->carried;
+                if (take > remaining) take = remaining;
+                memcpy(sink->staging + sink->carried, data, take);
+                sink->carried += take;
+                data += take;
+                remaining -= take;
+
+                size_t aligned = sink->carried - sink->carried % OUTPUT_ALIGNMENT;
+                if (aligned >= OUTPUT_BUFFER_SIZE) {
+                    if (writeAll(sink->fd, sink->staging, aligned) != 0) return -1;
+                    memmove(sink->staging, sink->staging + aligned, sink->carried - aligned);
+                    sink->carried -= aligned;
+                    sink->bytesWritten += aligned;
+                }
+            }
+        }
+        return 0;
+    }
+
+    struct iovec local[WRITEV_BATCH];
+    while (count > 0) {
+        int batch = count < WRITEV_BATCH ? count : WRITEV_BATCH;
+        memcpy(local, iov, (size_t)batch * sizeof(struct iovec));
+        struct iovec *pending = local;
+        int left = batch;
+
+        while (left > 0) {
+            ssize_t written = writev(sink->fd, pending, left);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            sink->bytesWritten += (size_t)written;
+            // Skip what went out; a short write leaves a partial iovec
+            while (left > 0 && (size_t)written >= pending->iov_len) {
+                written -= (ssize_t)pending->iov_len;
+                pending++;
+                left--;
+            }
+            if (left > 0) {
+                pending->iov_base = (char *)pending->iov_base + written;
+                pending->iov_len -= (size_t)written;
+            }
+        }
+        iov += batch;
+        count -= batch;
+    }
+    return 0;
+}
+
+// Write any carried tail and close the file (stdout is left open)
+int closeOutputSink(OutputSink *sink) {
+    int result = 0;
+    if (sink->direct && sink->carried > 0) {
+        // The last partial block can't go through O_DIRECT
+        int flags = fcntl(sink->fd, F_GETFL);
+        if (flags < 0 || fcntl(sink->fd, F_SETFL, flags & ~O_DIRECT) != 0 ||
+            writeAll(sink->fd, sink->staging, sink->carried) != 0) {
+            result = -1;
+        } else {
+            sink->bytesWritten += sink->carried;
+        }
+        sink->carried = 0;
+    }
+    if (sink->staging != NULL) {
+        explicit_bzero(sink->staging, OUTPUT_BUFFER_SIZE + OUTPUT_ALIGNMENT);
+        free(sink->staging);
+    }
+    sink->staging = NULL;
+    if (sink->fd != STDOUT_FILENO && close(sink->fd) != 0) {
+        result = -1;
+    }
+    return result;
+}
+
+// Set up an aligned block buffer that flushes to sink, carved from arena
+// when one is given (it then goes away with the arena) or allocated otherwise
+int initOutputBuffer(OutputBuffer *out, OutputSink *sink, SecretArena *arena) {
+    out->sink = sink;
+    out->used = 0;
+    out->capacity = OUTPUT_BUFFER_SIZE;
+    out->owned = arena == NULL;
+    if (arena != NULL) {
+        out->data = arenaAlloc(arena, out->capacity, OUTPUT_ALIGNMENT);
+        if (out->data == NULL) errno = ENOMEM;
+        return out->data == NULL ? -1 : 0;
+    }
+    if (posix_memalign((void **)&out->data, OUTPUT_ALIGNMENT, out->capacity) != 0) {
+        out->data = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// Write out everything buffered so far
+int flushOutputBuffer(OutputBuffer *out) {
+    struct iovec iov = {out->data, out->used};
+    if (out->used > 0 && sinkWritev(out->sink, &iov, 1) != 0) {
+        return -1;
+    }
+    out->used = 0;
+    return 0;
+}
+
+// Release the buffer; the sink belongs to the caller
+void freeOutputBuffer(OutputBuffer *out) {
+    if (out->owned && out->data != NULL) {
+        explicit_bzero(out->data, out->capacity);
+        free(out->data);
+    }
+    out->data = NULL;
+}
+
+// Largest record formatRecord() can produce for a password of this length
+static size_t maxRecordLength(OutputFormat format, int length) {
+    switch (format) {
+        case FORMAT_CSV:    return 2 * (size_t)length + 48;
+        case FORMAT_JSONL:  return 2 * (size_t)length + 64;
+        case FORMAT_BINARY: return (size_t)length + 1;
+        default:            return (size_t)length + 1;
+    }
+}
+
+// Decimal digits of value written at dest; returns the count
+static size_t formatNumber(char *dest, unsigned long long value) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (size_t i = 0; i < n; i++) dest[i] = digits[n - 1 - i];
+    return n;
+}
+
+// Write one output record at dest and return its size:
+//   plain   password\n
+//   csv     index,length,password\n (password quoted if it holds , or ")
+//   jsonl   {"index":N,"length":L,"password":"..."}\n
+//   binary  one length byte followed by the password bytes
+size_t formatRecord(char *dest, OutputFormat format, unsigned long long index, const char *password, int length) {
+    char *p = dest;
+
+    switch (format) {
+        case FORMAT_BINARY:
+            *p++ = (char)length;
+            memcpy(p, password, (size_t)length);
+            return (size_t)length + 1;
+
+        case FORMAT_CSV: {
+            p += formatNumber(p, index);
+            *p++ = ',';
+            p += formatNumber(p, (unsigned long long)length);
+            *p++ = ',';
+            int quote = memchr(password, ',', (size_t)length) || memchr(password, '"', (size_t)length);
+            if (quote) *p++ = '"';
+            for (int i = 0; i < length; i++) {
+                if (password[i] == '"') *p++ = '"';
+                *p++ = password[i];
+            }
+            if (quote) *p++ = '"';
+            *p++ = '\n';
+            return (size_t)(p - dest);
+        }
+
+        case FORMAT_JSONL:
+            memcpy(p, "{\"index\":", 9);
+            p += 9;
+            p += formatNumber(p, index);
+            memcpy(p, ",\"length\":", 10);
+            p += 10;
+            p += formatNumber(p, (unsigned long long)length);
+            memcpy(p, ",\"password\":\"", 13);
+            p += 13;
+            for (int i = 0; i < length; i++) {
+                if (password[i] == '"' || password[i] == '\\') *p++ = '\\';
+                *p++ = password[i];
+            }
+            memcpy(p, "\"}\n", 3);
+            return (size_t)(p - dest) + 3;
+
+        default:
+            memcpy(p, password, (size_t)length);
+            p[length] = '\n';
+            return (size_t)length + 1;
+    }
+}
+
+// Write parked buffers: called with the lock held by a worker that found no
+// writer active. Drops the lock around the writev() itself.
+static void writeReadyChunks(BulkJob *job) {
+    struct iovec batch[WRITEV_BATCH];
+    int slotsTaken[WRITEV_BATCH];
+    int n = 0;
+
+    if (job->options->ordered) {
+        // The consecutive run of finished chunks starting at nextChunkToWrite
+        for (int k = 0; k < job->slots && n < WRITEV_BATCH; k++) {
+            int slot = (int)((job->nextChunkToWrite + (unsigned long long)k) % (unsigned long long)job->slots);
+            if (!job->readyFlags[slot]) break;
+            batch[n] = job->ready[slot];
+            slotsTaken[n++] = slot;
+        }
+    } else {
+        for (int slot = 0; slot < job->slots && n < WRITEV_BATCH; slot++) {
+            if (job->readyFlags[slot]) {
+                batch[n] = job->ready[slot];
+                slotsTaken[n++] = slot;
+            }
+        }
+    }
+    if (n == 0) return;
+
+    job->writerActive = 1;
+    pthread_mutex_unlock(&job->writeLock);
+    int result = sinkWritev(job->sink, batch, n);
+    int error = errno;
+    pthread_mutex_lock(&job->writeLock);
+    job->writerActive = 0;
+
+    for (int i = 0; i < n; i++) {
+        job->readyFlags[slotsTaken[i]] = 0;
+    }
+    job->nextChunkToWrite += (unsigned long long)n;
+    if (result != 0) {
+        job->failed = 1;
+        job->error = error;
+    }
+    pthread_cond_broadcast(&job->writeTurn);
+}
+
+// Size a fingerprint set for expected passwords at a load of at most 3/4,
+// failing with EFBIG if that needs more than maxBytes
+int initFingerprintSet(FingerprintSet *set, unsigned long long expected, size_t maxBytes) {
+    uint64_t capacity = 1024;
+    while (capacity - capacity / 4 < expected) {
+        if (capacity > maxBytes / sizeof(uint64_t)) break;
+        capacity <<= 1;
+    }
+    if (capacity - capacity / 4 < expected || capacity * sizeof(uint64_t) > maxBytes) {
+        errno = EFBIG;
+        return -1;
+    }
+    // Probes land anywhere in the table, so ask for huge pages to spare the TLB
+    void *slots = mmap(NULL, capacity * sizeof(uint64_t), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (slots == MAP_FAILED) return -1;
+    madvise(slots, capacity * sizeof(uint64_t), MADV_HUGEPAGE);
+    if (readSystemEntropy(set->key, sizeof(set->key)) != 0) {
+        munmap(slots, capacity * sizeof(uint64_t));
+        return -1;
+    }
+    set->slots = slots;
+    set->mask = capacity - 1;
+    set->limit = capacity - capacity / 8;
+    atomic_init(&set->used, 0);
+    return 0;
+}
+
+// Wipe and release a fingerprint set
+void freeFingerprintSet(FingerprintSet *set) {
+    if (set->slots != NULL) {
+        explicit_bzero((void *)set->slots, (set->mask + 1) * sizeof(uint64_t));
+        munmap((void *)set->slots, (set->mask + 1) * sizeof(uint64_t));
+    }
+    memset(set, 0, sizeof(*set));
+}
+
+// Keyed 64-bit fingerprint of a password, never 0 (the empty-slot marker)
+uint64_t fingerprintPassword(const FingerprintSet *set, const char *password, size_t length) {
+    uint64_t h = set->key[0] ^ (length * 0x9E3779B97F4A7C15ULL);
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, password, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+        password += 8;
+        length -= 8;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, password, length);
+    h = (h ^ tail ^ set->key[1]) * 0x94D049BB133111EBULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 32;
+    return h ? h : 1;
+}
+
+// Add a fingerprint: 1 if it is new, 0 if it was already there, -1 if full
+int fingerprintSetInsert(FingerprintSet *set, uint64_t fingerprint) {
+    uint64_t slot = fingerprint & set->mask;
+    for (;;) {
+        uint64_t current = atomic_load_explicit(&set->slots[slot], memory_order_relaxed);
+        if (current == fingerprint) return 0;
+        if (current == 0) {
+            if (atomic_load_explicit(&set->used, memory_order_relaxed) >= set->limit) return -1;
+            if (atomic_compare_exchange_strong_explicit(&set->slots[slot], &current, fingerprint,
+                                                        memory_order_relaxed, memory_order_relaxed)) {
+                atomic_fetch_add_explicit(&set->used, 1, memory_order_relaxed);
+                return 1;
+            }
+            // Lost the race for this slot; current now holds the winner
+            if (current == fingerprint) return 0;
+        }
+        slot = (slot + 1) & set->mask;
+    }
+}
+
+// Password number index of a seeded stream, redrawn while it is in the
+// breach index; returns its length, or -1 with errno EAGAIN if every draw
+// was breached
+static int generateSeededPassword(char *password, int length, const CompiledCharset *charset,
+                                  const uint32_t key[8], uint64_t index) {
+    uint32_t attempt = 0;
+    do {
+        if (attempt == BREACH_MAX_ATTEMPTS) {
+            explicit_bzero(password, MAX_PASSWORD_LENGTH);
+            errno = EAGAIN;
+            return -1;
+        }
+        generatePasswordAt(password, length, charset, key, index, attempt++);
+    } while (passwordIsBreached(password, (size_t)length));
+    return length;
+}
+
+// Produce password number i of a bulk run; returns its length, or -1 if
+// every draw was in the breach index
+static int generateBulkPassword(BulkJob *job, RandomEngine *engine, char *password, unsigned long long i) {
+    const CommandLineOptions *options = job->options;
+
+    if (!options->seeded) {
+        return generateConfiguredPassword(password, &options->config, job->charset,
+                                          options->usePolicy ? &options->policy : NULL, engine);
+    }
+    return generateSeededPassword(password, options->config.length, job->charset, options->seedKey,
+                                  options->start + i);
+}
+
+// Draws allowed for one unique password: UNIQUE_MAX_ATTEMPTS times the
+// space / (space - used) draws a new password takes on average, so a run
+// that fills most of a small space still finishes
+static unsigned long long uniqueDrawLimit(const BulkJob *job) {
+    unsigned long long used = atomic_load_explicit(&job->unique->used, memory_order_relaxed);
+    if (job->space == 0 || used >= job->space) return UNIQUE_MAX_ATTEMPTS;
+    unsigned long long scale = job->space / (job->space - used);
+    return scale > ULLONG_MAX / UNIQUE_MAX_ATTEMPTS ? ULLONG_MAX : scale * UNIQUE_MAX_ATTEMPTS;
+}
+
+// Append passwords first..last-1 (at most UNIQUE_BATCH) to out, redrawing
+// any already seen. The set slots of the whole batch are prefetched before
+// the first probe, so their cache misses overlap instead of queueing.
+// Returns the number appended, -1 once the space looks exhausted, or -2 if
+// every draw of a password was in the breach index.
+static int appendUniqueBatch(BulkJob *job, RandomEngine *engine, OutputBuffer *out,
+                             char (*passwords)[MAX_PASSWORD_LENGTH],
+                             unsigned long long first, unsigned long long last) {
+    const CommandLineOptions *options = job->options;
+    FingerprintSet *set = job->unique;
+    int lengths[UNIQUE_BATCH];
+    uint64_t fingerprints[UNIQUE_BATCH];
+    int count = last - first < UNIQUE_BATCH ? (int)(last - first) : UNIQUE_BATCH;
+
+    for (int b = 0; b < count; b++) {
+        lengths[b] = generateBulkPassword(job, engine, passwords[b], first + b);
+        if (lengths[b] < 0) return -2;
+        fingerprints[b] = fingerprintPassword(set, passwords[b], (size_t)lengths[b]);
+        __builtin_prefetch((const void *)&set->slots[fingerprints[b] & set->mask], 1);
+    }
+    for (int b = 0; b < count; b++) {
+        int added;
+        unsigned long long attempts = 1;
+        unsigned long long limit = UNIQUE_MAX_ATTEMPTS;
+        while ((added = fingerprintSetInsert(set, fingerprints[b])) == 0) {
+            if (attempts == 1) limit = uniqueDrawLimit(job);
+            if (attempts >= limit) break;
+            atomic_fetch_add_explicit(&job->duplicates, 1, memory_order_relaxed);
+            lengths[b] = generateBulkPassword(job, engine, passwords[b], first + b);
+            if (lengths[b] < 0) return -2;
+            fingerprints[b] = fingerprintPassword(set, passwords[b], (size_t)lengths[b]);
+            attempts++;
+        }
+        if (added <= 0) {
+            count = -1;
+            break;
+        }
+        if (options->format == FORMAT_PLAIN) {
+            memcpy(out->data + out->used, passwords[b], (size_t)lengths[b]);
+            out->data[out->used + (size_t)lengths[b]] = '\n';
+            out->used += (size_t)lengths[b] + 1;
+        } else {
+            out->used += formatRecord(out->data + out->used, options->format, options->start + first + b,
+                                      passwords[b], lengths[b]);
+        }
+    }
+    return count;
+}
+
+// Generate chunk after chunk with a private RNG stream and output buffer,
+// all carved from the run's secret arena
+static void *bulkWorker(void *arg) {
+    BulkJob *job = arg;
+    const CommandLineOptions *options = job->options;
+    OutputBuffer out;
+    RandomEngine *engine = arenaAlloc(job->arena, sizeof(RandomEngine), 64);
+    // One password of scratch for formatting, then a --unique batch
+    char (*scratch)[MAX_PASSWORD_LENGTH] = arenaAlloc(job->arena, (UNIQUE_BATCH + 1) * MAX_PASSWORD_LENGTH, 64);
+
+    if (engine == NULL || scratch == NULL || initChaChaEngine(engine) != 0 ||
+        initOutputBuffer(&out, job->sink, job->arena) != 0) {
+        pthread_mutex_lock(&job->writeLock);
+        job->failed = 1;
+        job->error = engine == NULL || scratch == NULL ? ENOMEM : errno;
+        pthread_cond_broadcast(&job->writeTurn);
+        pthread_mutex_unlock(&job->writeLock);
+        return NULL;
+    }
+
+    for (;;) {
+        unsigned long long chunk = atomic_fetch_add(&job->nextChunk, 1);
+        if (chunk >= job->chunkCount) break;
+
+        unsigned long long first = chunk * job->passwordsPerChunk;
+        unsigned long long last = first + job->passwordsPerChunk;
+        if (last > options->count) last = options->count;
+
+        for (unsigned long long i = first; i < last && job->unique != NULL; ) {
+            int appended = appendUniqueBatch(job, engine, &out, scratch + 1, i, last);
+            if (appended < 0) {
+                pthread_mutex_lock(&job->writeLock);
+                job->failed = 1;
+                if (appended == -1) job->exhausted = 1;
+                else job->breached = 1;
+                pthread_cond_broadcast(&job->writeTurn);
+                pthread_mutex_unlock(&job->writeLock);
+                break;
+            }
+            i += (unsigned long long)appended;
+        }
+        for (unsigned long long i = first; i < last && job->unique == NULL; i++) {
+            // Plain output is generated in place; other formats go via a copy
+            char *password = options->format == FORMAT_PLAIN ? out.data + out.used : scratch[0];
+            int length = generateBulkPassword(job, engine, password, i);
+
+            if (length < 0) {
+                pthread_mutex_lock(&job->writeLock);
+                job->failed = 1;
+                job->breached = 1;
+                pthread_cond_broadcast(&job->writeTurn);
+                pthread_mutex_unlock(&job->writeLock);
+                break;
+            }
+            if (options->format == FORMAT_PLAIN) {
+                // The generators terminate with '\0'; turn that into the newline
+                password[length] = '\n';
+                out.used += (size_t)length + 1;
+            } else {
+                out.used += formatRecord(out.data + out.used, options->format, options->start + i, password, length);
+            }
+        }
+
+        pthread_mutex_lock(&job->writeLock);
+        if (job->failed) {
+            pthread_mutex_unlock(&job->writeLock);
+            break;
+        }
+        int slot = (int)(chunk % (unsigned long long)job->slots);
+        // The slot may still hold an unwritten chunk from the previous round
+        while (job->readyFlags[slot] && !job->failed) {
+            if (!job->writerActive && !options->ordered) {
+                writeReadyChunks(job);
+            } else {
+                pthread_cond_wait(&job->writeTurn, &job->writeLock);
+            }
+        }
+        if (job->failed) {
+            pthread_mutex_unlock(&job->writeLock);
+            break;
+        }
+        job->ready[slot].iov_base = out.data;
+        job->ready[slot].iov_len = out.used;
+        job->readyFlags[slot] = 1;
+        while (job->readyFlags[slot] && !job->failed) {
+            if (!job->writerActive && (!options->ordered || job->nextChunkToWrite == chunk)) {
+                writeReadyChunks(job);
+            } else {
+                pthread_cond_wait(&job->writeTurn, &job->writeLock);
+            }
+        }
+        int failed = job->failed;
+        pthread_mutex_unlock(&job->writeLock);
+        out.used = 0;
+        if (failed) break;
+    }
+
+    // The engine and buffers are wiped when the run resets the arena
+    freeOutputBuffer(&out);
+    return NULL;
+}
+
+// Number of distinct passwords of the configuration, saturating at
+// ULLONG_MAX. Only plain random and passphrase modes are counted (0 for the
+// others); a near-exhausted space there is caught by the redraw limit.
+static unsigned long long passwordSpaceSize(const CommandLineOptions *options, const CompiledCharset *charset) {
+    unsigned long long base, space = 1;
+    int draws;
+    if (options->config.mode == PASSWORD_MODE_PASSPHRASE && activeWordlist != NULL) {
+        base = activeWordlist->count;
+        draws = options->config.wordCount;
+    } else if (options->config.mode == PASSWORD_MODE_RANDOM && !options->usePolicy) {
+        base = (unsigned long long)charset->size;
+        draws = options->config.length;
+    } else {
+        return 0;
+    }
+    for (int i = 0; i < draws && space < ULLONG_MAX; i++) {
+        space = space > ULLONG_MAX / base ? ULLONG_MAX : space * base;
+    }
+    return space;
+}
+
+// Split the requested count into chunks and generate them on a worker pool
+int runBulkGeneration(const CommandLineOptions *options) {
+    OutputSink sink;
+    if (openOutputSink(&sink, options->outputPath, options->directIo) != 0) {
+        fprintf(stderr, "Error: could not open output '%s': %s\n",
+                options->outputPath ? options->outputPath : "-", strerror(errno));
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    CompiledCharset charset;
+    compileCharset(&charset, &options->config);
+
+    FingerprintSet uniqueSet;
+    unsigned long long space = options->unique ? passwordSpaceSize(options, &charset) : 0;
+    if (space != 0 && space < options->count) {
+        fprintf(stderr, "Error: --unique asks for %llu passwords, more than this configuration can produce\n",
+                options->count);
+        closeOutputSink(&sink);
+        return 1;
+    }
+    if (options->unique) {
+        if (initFingerprintSet(&uniqueSet, options->count, (size_t)(options->uniqueMemory << 20)) != 0) {
+            if (errno == EFBIG) {
+                fprintf(stderr, "Error: --unique for %llu passwords needs more than %llu MiB; raise --unique-memory\n",
+                        options->count, options->uniqueMemory);
+            } else {
+                fprintf(stderr, "Error: could not set up the uniqueness set: %s\n", strerror(errno));
+            }
+            closeOutputSink(&sink);
+            return 1;
+        }
+    }
+
+    BulkJob job = {
+        .options = options,
+        .charset = &charset,
+        .sink = &sink,
+        .unique = options->unique ? &uniqueSet : NULL,
+        .space = space,
+        .passwordsPerChunk = OUTPUT_BUFFER_SIZE / maxRecordLength(options->format,
+            options->config.mode == PASSWORD_MODE_PASSPHRASE ? MAX_PASSWORD_LENGTH - 1 : options->config.length),
+        .nextChunkToWrite = 0,
+        .writerActive = 0,
+        .failed = 0,
+        .error = 0,
+        .exhausted = 0,
+        .breached = 0
+    };
+    job.chunkCount = (options->count + job.passwordsPerChunk - 1) / job.passwordsPerChunk;
+    atomic_init(&job.nextChunk, 0);
+    atomic_init(&job.duplicates, 0);
+
+    int threads = options->threads;
+    if ((unsigned long long)threads > job.chunkCount) {
+        threads = job.chunkCount > 0 ? (int)job.chunkCount : 1;
+    }
+    job.slots = threads;
+    job.ready = calloc((size_t)threads, sizeof(struct iovec));
+    job.readyFlags = calloc((size_t)threads, 1);
+    pthread_t *workers = calloc((size_t)threads, sizeof(pthread_t));
+
+    // Per worker: the output buffer, the RNG engine and password scratch
+    SecretArena arena;
+    size_t perWorker = OUTPUT_BUFFER_SIZE + OUTPUT_ALIGNMENT + sizeof(RandomEngine) + 64 +
+                       (UNIQUE_BATCH + 1) * MAX_PASSWORD_LENGTH + 64;
+    int arenaReady = initSecretArena(&arena, (size_t)threads * perWorker) == 0;
+    job.arena = &arena;
+    if (job.ready == NULL || job.readyFlags == NULL || workers == NULL || !arenaReady) {
+        fprintf(stderr, "Error: out of memory\n");
+        free(job.ready);
+        free(job.readyFlags);
+        free(workers);
+        if (arenaReady) destroySecretArena(&arena);
+        if (job.unique != NULL) freeFingerprintSet(job.unique);
+        closeOutputSink(&sink);
+        return 1;
+    }
+    pthread_mutex_init(&job.writeLock, NULL);
+    pthread_cond_init(&job.writeTurn, NULL);
+
+    if (options->format == FORMAT_CSV) {
+        struct iovec header = {"index,length,password\n", 22};
+        if (sinkWritev(&sink, &header, 1) != 0) {
+            job.failed = 1;
+            job.error = errno;
+        }
+    }
+
+    // The calling thread is always worker 0
+    int started = 1;
+    if (!job.failed) {
+        for (; started < threads; started++) {
+            if (pthread_create(&workers[started], NULL, bulkWorker, &job) != 0) break;
+        }
+        bulkWorker(&job);
+    }
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    free(workers);
+    free(job.ready);
+    free(job.readyFlags);
+    destroySecretArena(&arena);
+
+    pthread_mutex_destroy(&job.writeLock);
+    pthread_cond_destroy(&job.writeTurn);
+
+    if (closeOutputSink(&sink) != 0 && !job.failed) {
+        job.failed = 1;
+        job.error = errno;
+    }
+    unsigned long long duplicates = atomic_load(&job.duplicates);
+    unsigned long long uniqueSlots = job.unique != NULL ? job.unique->mask + 1 : 0;
+    unsigned long long uniqueUsed = job.unique != NULL ? atomic_load(&job.unique->used) : 0;
+    if (job.unique != NULL) freeFingerprintSet(job.unique);
+
+    if (job.exhausted) {
+        fprintf(stderr, "Error: no new unique password found; the password space is nearly exhausted\n");
+        return 1;
+    }
+    if (job.breached) {
+        fprintf(stderr, "Error: %d draws in a row were in the breach index; the password space is too small\n",
+                BREACH_MAX_ATTEMPTS);
+        return 1;
+    }
+    if (job.failed) {
+        fprintf(stderr, "Error: bulk generation failed: %s\n", strerror(job.error));
+        return 1;
+    }
+    if (job.nextChunkToWrite != job.chunkCount) {
+        fprintf(stderr, "Error: bulk generation wrote %llu of %llu chunks\n",
+                job.nextChunkToWrite, job.chunkCount);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double megabytes = sink.bytesWritten / (1024.0 * 1024.0);
+    // A plain run printing one password keeps stderr quiet
+    if (options->bulk) {
+        fprintf(stderr, "Generated %llu passwords (%.1f MB) in %.3f s (%.1f MB/s, %d thread%s)\n",
+                options->count, megabytes, seconds, seconds > 0 ? megabytes / seconds : 0.0,
+                started, started == 1 ? "" : "s");
+    }
+    if (options->unique) {
+        fprintf(stderr, "Unique: %llu duplicates redrawn (%.6f%% of draws), set %.1f MiB, %.1f%% full\n",
+                duplicates, 100.0 * duplicates / (double)(options->count + duplicates),
+                uniqueSlots * sizeof(uint64_t) / (1024.0 * 1024.0), 100.0 * uniqueUsed / (double)uniqueSlots);
+    }
+    return 0;
+}
+
+// Seconds elapsed since start
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Check a password against the one regenerated from (seed, start)
+int runVerify(const CommandLineOptions *options) {
+    char password[MAX_PASSWORD_LENGTH];
+    CompiledCharset charset;
+
+    compileCharset(&charset, &options->config);
+    if (generateSeededPassword(password, options->config.length, &charset, options->seedKey,
+                               options->start) < 0) {
+        fprintf(stderr, "Error: no draw of password %llu is outside the breach index\n", options->start);
+        return 1;
+    }
+
+    if (strcmp(password, options->verifyPassword) != 0) {
+        printf("mismatch: password %llu differs\n", options->start);
+        return 1;
+    }
+    printf("match: password %llu\n", options->start);
+    return 0;
+}
+
+// Move a nominal chunk boundary to the start of the next line, so each
+// line is rated by exactly one chunk
+static size_t alignToLine(const char *data, size_t size, size_t position) {
+    if (position == 0 || position >= size) {
+        return position >= size ? size : 0;
+    }
+    const char *newline = memchr(data + position - 1, '\n', size - position + 1);
+    return newline ? (size_t)(newline - data) + 1 : size;
+}
+
+typedef struct {
+    AuditJob *job;
+    int index;
+} AuditWorker;
+
+// Claim chunks until none are left, counting into this worker's histogram
+static void *auditWorker(void *arg) {
+    AuditWorker *worker = arg;
+    AuditJob *job = worker->job;
+    AuditHistogram local;
+    memset(&local, 0, sizeof(local));
+
+    for (;;) {
+        size_t chunk = atomic_fetch_add(&job->nextChunk, 1);
+        if (chunk >= job->chunkCount) break;
+
+        size_t begin = alignToLine(job->data, job->size, chunk * job->chunkSize);
+        size_t end = alignToLine(job->data, job->size, (chunk + 1) * job->chunkSize);
+        if (begin < end) {
+            auditBuffer(job->data + begin, end - begin, job->classify, &local);
+        }
+    }
+    job->histograms[worker->index] = local;
+    return NULL;
+}
+
+// Memory-map a password file, rate it on a worker pool and print the
+// strength histogram with throughput figures
+int runAudit(const CommandLineOptions *options) {
+    int fd = open(options->auditPath, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", options->auditPath, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    AuditHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    int threads = 1;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (info.st_size > 0) {
+        void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            fprintf(stderr, "Error: could not map '%s': %s\n", options->auditPath, strerror(errno));
+            close(fd);
+            return 1;
+        }
+        madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+        AuditJob job = {
+            .data = data,
+            .size = (size_t)info.st_size,
+            .chunkSize = AUDIT_CHUNK_SIZE,
+            .classify = selectClassifier(!options->noSimd)
+        };
+        job.chunkCount = (job.size + job.chunkSize - 1) / job.chunkSize;
+        atomic_init(&job.nextChunk, 0);
+
+        threads = options->threads;
+        if ((size_t)threads > job.chunkCount) threads = (int)job.chunkCount;
+
+        job.histograms = calloc((size_t)threads, sizeof(AuditHistogram));
+        AuditWorker *workers = calloc((size_t)threads, sizeof(AuditWorker));
+        pthread_t *ids = calloc((size_t)threads, sizeof(pthread_t));
+        if (job.histograms == NULL || workers == NULL || ids == NULL) {
+            fprintf(stderr, "Error: out of memory\n");
+            free(job.histograms);
+            free(workers);
+            free(ids);
+            munmap(data, job.size);
+            close(fd);
+            return 1;
+        }
+
+        // The calling thread is always worker 0
+        int started = 1;
+        for (int t = 0; t < threads; t++) {
+            workers[t].job = &job;
+            workers[t].index = t;
+        }
+        for (; started < threads; started++) {
+            if (pthread_create(&ids[started], NULL, auditWorker, &workers[started]) != 0) break;
+        }
+        auditWorker(&workers[0]);
+        for (int t = 1; t < started; t++) {
+            pthread_join(ids[t], NULL);
+        }
+        threads = started;
+
+        for (int t = 0; t < threads; t++) {
+            for (int b = 0; b < STRENGTH_BUCKETS; b++) {
+                histogram.buckets[b] += job.histograms[t].buckets[b];
+            }
+            histogram.lines += job.histograms[t].lines;
+            histogram.bytes += job.histograms[t].bytes;
+            histogram.breached += job.histograms[t].breached;
+        }
+
+        free(job.histograms);
+        free(workers);
+        free(ids);
+        munmap(data, job.size);
+    }
+    close(fd);
+
+    double seconds = elapsedSeconds(&start);
+    printf("Audited %llu passwords from '%s'\n", histogram.lines, options->auditPath);
+    for (int b = STRENGTH_BUCKETS - 1; b >= 0; b--) {
+        printf("  %-22s %12llu  %6.2f%%\n", strengthLabels[b], histogram.buckets[b],
+               histogram.lines ? 100.0 * histogram.buckets[b] / histogram.lines : 0.0);
+    }
+    if (activeBreachIndex != NULL) {
+        printf("  %-22s %12llu  %6.2f%%\n", "⚠️  Breached", histogram.breached,
+               histogram.lines ? 100.0 * histogram.breached / histogram.lines : 0.0);
+    }
+    fprintf(stderr, "Audit took %.3f s on %d thread%s (%.0f lines/s, %.1f MB/s)\n",
+            seconds, threads, threads == 1 ? "" : "s",
+            seconds > 0 ? histogram.lines / seconds : 0.0,
+            seconds > 0 ? histogram.bytes / (1024.0 * 1024.0) / seconds : 0.0);
+    return 0;
+}
+
+// Value of one hex digit, or -1
+static int hexValue(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// LSD radix sort, one byte per pass; scratch must hold count values
+static void radixSort64(uint64_t *values, uint64_t *scratch, size_t count) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t offsets[257] = {0};
+        for (size_t i = 0; i < count; i++) offsets[(values[i] >> shift & 0xFF) + 1]++;
+        for (int b = 0; b < 256; b++) offsets[b + 1] += offsets[b];
+        for (size_t i = 0; i < count; i++) scratch[offsets[values[i] >> shift & 0xFF]++] = values[i];
+        uint64_t *swap = values;
+        values = scratch;
+        scratch = swap;
+    }
+    // Eight passes end with the data back in the original array
+}
+
+// Turn a text corpus of SHA-1 hex lines (HIBP "HASH:count" format) into a
+// sorted binary index with a prefix table and Bloom filter
+int buildBreachIndex(const char *corpusPath, const char *indexPath) {
+    int fd = open(corpusPath, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", corpusPath, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    size_t size = (size_t)info.st_size;
+    const char *data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Error: could not map '%s': %s\n", corpusPath, strerror(errno));
+        return 1;
+    }
+    if (data != NULL) madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    // Every usable line holds 40 hex digits plus a newline
+    size_t capacity = size / 41 + 1;
+    uint64_t bloomBits = 64;
+    while (bloomBits < (uint64_t)capacity * 10) bloomBits <<= 1;
+    uint32_t prefixBits = 8;
+    while (prefixBits < 28 && ((uint64_t)capacity >> prefixBits) > 16) prefixBits++;
+
+    uint64_t *fingerprints = malloc(capacity * sizeof(uint64_t));
+    uint64_t *scratch = malloc(capacity * sizeof(uint64_t));
+    uint64_t *bloom = calloc(bloomBits / 64, sizeof(uint64_t));
+    uint64_t *prefixTable = calloc(((size_t)1 << prefixBits) + 1, sizeof(uint64_t));
+    if (fingerprints == NULL || scratch == NULL || bloom == NULL || prefixTable == NULL) {
+        fprintf(stderr, "Error: out of memory for %zu entries\n", capacity);
+        free(fingerprints);
+        free(scratch);
+        free(bloom);
+        free(prefixTable);
+        if (data != NULL) munmap((void *)data, size);
+        return 1;
+    }
+
+    const uint32_t bloomHashes = 7;
+    size_t count = 0;
+    unsigned long long skipped = 0;
+    const char *p = data;
+    const char *end = data + size;
+    while (p != NULL && p < end) {
+        const char *newline = memchr(p, '\n', (size_t)(end - p));
+        const char *lineEnd = newline ? newline : end;
+        unsigned char digest[20];
+        int valid = lineEnd - p >= 40;
+
+        for (int i = 0; valid && i < 20; i++) {
+            int high = hexValue(p[2 * i]);
+            int low = hexValue(p[2 * i + 1]);
+            valid = high >= 0 && low >= 0;
+            digest[i] = (unsigned char)(high << 4 | low);
+        }
+        if (valid && (lineEnd - p == 40 || p[40] == ':' || p[40] == '\r')) {
+            fingerprints[count++] = digestWord(digest);
+            for (uint32_t i = 0; i < bloomHashes; i++) {
+                uint64_t bit = BLOOM_PROBE(digest, i, bloomBits - 1);
+                bloom[bit / 64] |= (uint64_t)1 << (bit % 64);
+            }
+        } else if (lineEnd > p) {
+            skipped++;
+        }
+        p = lineEnd + 1;
+    }
+    if (data != NULL) munmap((void *)data, size);
+
+    radixSort64(fingerprints, scratch, count);
+    free(scratch);
+
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || fingerprints[unique - 1] != fingerprints[i]) {
+            fingerprints[unique++] = fingerprints[i];
+        }
+    }
+
+    // prefixTable[b] is the first entry whose top bits are >= b
+    size_t entry = 0;
+    for (uint64_t bucket = 0; bucket <= ((uint64_t)1 << prefixBits); bucket++) {
+        while (entry < unique && (fingerprints[entry] >> (64 - prefixBits)) < bucket) entry++;
+        prefixTable[bucket] = entry;
+    }
+
+    BreachIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BREACH_INDEX_MAGIC, 8);
+    header.count = unique;
+    header.prefixBits = prefixBits;
+    header.bloomHashes = bloomHashes;
+    header.bloomBits = bloomBits;
+
+    FILE *file = fopen(indexPath, "wb");
+    int failed = file == NULL;
+    if (!failed) {
+        setvbuf(file, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+        failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 fwrite(prefixTable, sizeof(uint64_t), ((size_t)1 << prefixBits) + 1, file) != ((size_t)1 << prefixBits) + 1 ||
+                 fwrite(bloom, sizeof(uint64_t), bloomBits / 64, file) != bloomBits / 64 ||
+                 fwrite(fingerprints, sizeof(uint64_t), unique, file) != unique;
+        failed = (fclose(file) != 0) || failed;
+    }
+    free(fingerprints);
+    free(bloom);
+    free(prefixTable);
+
+    if (failed) {
+        fprintf(stderr, "Error: could not write '%s': %s\n", indexPath, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "Indexed %zu hashes (%zu duplicates, %llu lines skipped) into '%s'\n",
+            unique, count - unique, skipped, indexPath);
+    return 0;
+}
+
+// Table row of the context reached from context by emitting outcome
+static uint32_t markovNextRow(uint32_t context, uint32_t outcome) {
+    if (outcome >= 26) return (outcome - 26 + 1) * MARKOV_OUTCOMES;
+    return ((context % MARKOV_SYMBOLS) * MARKOV_SYMBOLS + outcome + 1) * MARKOV_OUTCOMES;
+}
+
+// Fill one context's alias table (Vose's method) from outcome weights
+static void buildAliasTable(uint64_t *table, uint32_t context, const double *weights) {
+    double scaled[MARKOV_OUTCOMES];
+    int small[MARKOV_OUTCOMES], large[MARKOV_OUTCOMES];
+    int smallCount = 0, largeCount = 0;
+    double total = 0;
+
+    for (int i = 0; i < MARKOV_OUTCOMES; i++) total += weights[i];
+    for (int i = 0; i < MARKOV_OUTCOMES; i++) {
+        scaled[i] = weights[i] * MARKOV_OUTCOMES / total;
+        if (scaled[i] < 1.0) small[smallCount++] = i;
+        else large[largeCount++] = i;
+    }
+    while (smallCount > 0 && largeCount > 0) {
+        int less = small[--smallCount];
+        int more = large[--largeCount];
+        uint32_t threshold = (uint32_t)(scaled[less] * (1 << 24) + 0.5);
+        if (threshold > 0xFFFFFF) threshold = 0xFFFFFF;
+        table[less] = MARKOV_ENTRY(threshold, more, markovNextRow(context, (uint32_t)more),
+                                   markovNextRow(context, (uint32_t)less));
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) small[smallCount++] = more;
+        else large[largeCount++] = more;
+    }
+    // Whatever is left has probability 1 up to rounding and is its own alias
+    while (largeCount > 0 || smallCount > 0) {
+        int i = largeCount > 0 ? large[--largeCount] : small[--smallCount];
+        uint32_t next = markovNextRow(context, (uint32_t)i);
+        table[i] = MARKOV_ENTRY(0xFFFFFF, i, next, next);
+    }
+}
+
+// Count letter trigrams in a text corpus and write the alias tables. Words
+// are runs of letters; contexts never seen fall back to the last letter, then
+// to the word-start distribution.
+int trainMarkovModel(const char *corpusPath, const char *modelPath) {
+    int fd = open(corpusPath, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "Error: could not open '%s': %s\n", corpusPath, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    size_t size = (size_t)info.st_size;
+    const char *data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Error: could not map '%s': %s\n", corpusPath, strerror(errno));
+        return 1;
+    }
+    if (data != NULL) madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    // counts[context][next], next 0 being the end of the word
+    uint64_t (*counts)[MARKOV_SYMBOLS] = calloc(MARKOV_CONTEXTS, sizeof(*counts));
+    uint64_t *table = malloc((size_t)MARKOV_CONTEXTS * MARKOV_OUTCOMES * sizeof(uint64_t));
+    if (counts == NULL || table == NULL) {
+        fprintf(stderr, "Error: out of memory\n");
+        free(counts);
+        free(table);
+        if (data != NULL) munmap((void *)data, size);
+        return 1;
+    }
+
+    uint64_t words = 0;
+    uint32_t context = 0;
+    for (size_t i = 0; i <= size; i++) {
+        int c = i < size ? tolower((unsigned char)data[i]) : 0;
+        if (c >= 'a' && c <= 'z') {
+            uint32_t symbol = (uint32_t)(c - 'a' + 1);
+            counts[context][symbol]++;
+            context = (context % MARKOV_SYMBOLS) * MARKOV_SYMBOLS + symbol;
+        } else if (context != 0) {
+            counts[context][0]++;
+            context = 0;
+            words++;
+        }
+    }
+    if (data != NULL) munmap((void *)data, size);
+    if (words == 0) {
+        fprintf(stderr, "Error: '%s' contains no words\n", corpusPath);
+        free(counts);
+        free(table);
+        return 1;
+    }
+
+    // Order-1 counts for the backoff
+    uint64_t lastLetter[MARKOV_SYMBOLS][MARKOV_SYMBOLS];
+    memset(lastLetter, 0, sizeof(lastLetter));
+    for (int ctx = 0; ctx < MARKOV_CONTEXTS; ctx++) {
+        for (int next = 0; next < MARKOV_SYMBOLS; next++) {
+            lastLetter[ctx % MARKOV_SYMBOLS][next] += counts[ctx][next];
+        }
+    }
+
+    const uint64_t *start = counts[0];
+    for (int ctx = 0; ctx < MARKOV_CONTEXTS; ctx++) {
+        const uint64_t *source = counts[ctx];
+        uint64_t total = 0;
+        for (int next = 0; next < MARKOV_SYMBOLS; next++) total += source[next];
+        if (total == 0 && ctx % MARKOV_SYMBOLS != 0) {
+            source = lastLetter[ctx % MARKOV_SYMBOLS];
+            for (int next = 0; next < MARKOV_SYMBOLS; next++) total += source[next];
+        }
+        if (total == 0) {
+            source = start;
+            for (int next = 0; next < MARKOV_SYMBOLS; next++) total += source[next];
+        }
+
+        // Ending a word and starting the next one is folded into one outcome
+        double weights[MARKOV_OUTCOMES];
+        double endWeight = source == start ? 1.0 : (double)source[0] / (double)total;
+        for (int letter = 0; letter < 26; letter++) {
+            weights[letter] = source == start ? 0.0 : (double)source[letter + 1] / (double)total;
+            weights[26 + letter] = endWeight * (double)start[letter + 1] / (double)words;
+        }
+        buildAliasTable(table + (size_t)ctx * MARKOV_OUTCOMES, (uint32_t)ctx, weights);
+    }
+    free(counts);
+
+    MarkovModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MARKOV_MODEL_MAGIC, 8);
+    header.symbols = MARKOV_SYMBOLS;
+    header.outcomes = MARKOV_OUTCOMES;
+    header.trainedWords = words;
+
+    FILE *file = fopen(modelPath, "wb");
+    int failed = file == NULL;
+    if (!failed) {
+        size_t entries = (size_t)MARKOV_CONTEXTS * MARKOV_OUTCOMES;
+        failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 fwrite(table, sizeof(uint64_t), entries, file) != entries;
+        failed = (fclose(file) != 0) || failed;
+    }
+    free(table);
+
+    if (failed) {
+        fprintf(stderr, "Error: could not write '%s': %s\n", modelPath, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "Trained a letter model on %llu words into '%s'\n", (unsigned long long)words, modelPath);
+    return 0;
+}
+
+// Fill every ring that is below capacity, then sleep on the eventfd until
+// the event loop reports that one has dropped under half
+static void *daemonRefillThread(void *arg) {
+    DaemonState *state = arg;
+    uint64_t wakeups;
+
+    while (!atomic_load(&state->stopping)) {
+        for (int p = 0; p < state->profileCount; p++) {
+            PasswordRing *ring = &state->rings[p];
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            while (tail - head < DAEMON_RING_SIZE) {
+                // A profile whose every draw is breached is left for the
+                // event loop to report
+                if (generateConfiguredPassword(ring->slots[tail & (DAEMON_RING_SIZE - 1)],
+                                               &state->profiles[p].config, &ring->charset, NULL,
+                                               state->refillEngine) < 0) break;
+                tail++;
+                atomic_store_explicit(&ring->tail, tail, memory_order_release);
+                if (tail - head == DAEMON_RING_SIZE) {
+                    head = atomic_load_explicit(&ring->head, memory_order_acquire);
+                }
+            }
+        }
+        if (read(state->refillEvent, &wakeups, sizeof(wakeups)) < 0 && errno != EINTR) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Take one password of profile p into dest and return its length, or -1 if
+// the ring is empty and no draw is outside the breach index. The slot is
+// wiped once copied; an empty ring is bridged by generating in place.
+static int daemonTakePassword(DaemonState *state, int p, char *dest) {
+    PasswordRing *ring = &state->rings[p];
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    int length;
+
+    ring->served++;
+    if (head == tail) {
+        ring->generatedInline++;
+        length = generateConfiguredPassword(dest, &state->profiles[p].config, &ring->charset, NULL,
+                                            state->inlineEngine);
+    } else {
+        char *slot = ring->slots[head & (DAEMON_RING_SIZE - 1)];
+        length = (int)strlen(slot);
+        memcpy(dest, slot, (size_t)length);
+        explicit_bzero(slot, (size_t)length);
+        atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    }
+    if (tail - head == DAEMON_RING_SIZE / 2) {
+        uint64_t one = 1;
+        if (write(state->refillEvent, &one, sizeof(one)) < 0) {
+            // The counter only saturates if the refill thread is gone
+        }
+    }
+    return length;
 }
 
-// Display fancy separator
-void printSeparator() {
-    printf("\n");
-    for (int i = 0; i < 50; i++) printf("═");
-    printf("\n\n");
+// Make room for size more response bytes
+static int daemonReserve(DaemonClient *client, size_t size) {
+    if (client->outputUsed + size <= client->outputCapacity) return 0;
+    size_t capacity = client->outputCapacity ? client->outputCapacity : 4096;
+    while (capacity < client->outputUsed + size) capacity *= 2;
+    char *grown = malloc(capacity);
+    if (grown == NULL) return -1;
+    if (client->output != NULL) {
+        memcpy(grown, client->output, client->outputUsed);
+        explicit_bzero(client->output, client->outputCapacity);
+        free(client->output);
+    }
+    client->output = grown;
+    client->outputCapacity = capacity;
+    return 0;
 }
 
-// Main menu
-void displayMainMenu() {
-    clearScreen();
-    printf("\n");
-    printf("    ╔════════════════════════════════════════════╗\n");
-    printf("    ║    🔐 PASSWORD GENERATOR v1.0              ║\n");
-    printf("    ╚════════════════════════════════════════════╝\n");
-    printSeparator();
-    printf("  1. ⚡ Generate Passwords (Quick)\n");
-    printf("  2. ⚙️  Configure Settings\n");
-    printf("  3. 💾 Save Passwords to File\n");
-    printf("  4. ℹ️  About This App\n");
-    printf("  5. 🚪 Exit\n");
-    printSeparator();
-    printf("  Enter your choice (1-5): ");
+// Append formatted text to a client's response
+static void daemonReply(DaemonClient *client, const char *format, ...) __attribute__((format(printf, 2, 3)));
+static void daemonReply(DaemonClient *client, const char *format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length < 0) return;
+    if ((size_t)length >= sizeof(line)) length = sizeof(line) - 1;
+    if (daemonReserve(client, (size_t)length) != 0) {
+        client->closing = 1;
+        return;
+    }
+    memcpy(client->output + client->outputUsed, line, (size_t)length);
+    client->outputUsed += (size_t)length;
 }
 
-// Character selection menu
-void displayCharacterMenu() {
-    printf("\n");
-    printf("  ╔════════════════════════════════════════════╗\n");
-    printf("  ║     SELECT CHARACTER TYPES TO INCLUDE     ║\n");
-    printf("  ╚══════���═════════════════════════════════════╝\n");
-    printSeparator();
-}
+// Answer one request line:
+//   GET <profile> [count]  ->  OK <count>, then one password per line
+//   STATS                  ->  OK <profiles>, then "name buffered served inline" lines
+// Anything else gets ERR <reason>.
+static void daemonHandleLine(DaemonState *state, DaemonClient *client, char *line) {
+    char *save = NULL;
+    char *command = strtok_r(line, " \t\r", &save);
+    if (command == NULL) return;
 
-// Settings menu
-void displaySettingsMenu(PasswordConfig *config) {
-    clearScreen();
-    printf("\n");
-    printf("  ╔════════════════════════════════════════════╗\n");
-    printf("  ║           PASSWORD SETTINGS               ║\n");
-    printf("  ╚════════════════════════════════════════════╝\n");
-    printSeparator();
-    printf("  Current Settings:\n");
-    printf("  • Length: %d characters\n", config->length);
-    printf("  • Lowercase: %s\n", config->useLower ? "✓ Enabled" : "✗ Disabled");
-    printf("  • Uppercase: %s\n", config->useUpper ? "✓ Enabled" : "✗ Disabled");
-    printf("  • Digits: %s\n", config->useDigits ? "✓ Enabled" : "✗ Disabled");
-    printf("  • Special Characters: %s\n", config->useSpecial ? "✓ Enabled" : "✗ Disabled");
-    printSeparator();
-    printf("  1. Change Password Length\n");
-    printf("  2. Toggle Character Types\n");
-    printf("  3. Reset to Default\n");
-    printf("  4. Back to Main Menu\n");
-    printSeparator();
-    printf("  Enter your choice (1-4): ");
+    if (strcmp(command, "GET") == 0) {
+        char *name = strtok_r(NULL, " \t\r", &save);
+        char *countText = strtok_r(NULL, " \t\r", &save);
+        unsigned long long count = 1;
+        int p = 0;
+        if (name == NULL) {
+            daemonReply(client, "ERR usage: GET <profile> [count]\n");
+            return;
+        }
+        while (p < state->profileCount && strcmp(state->profiles[p].name, name) != 0) p++;
+        if (p == state->profileCount) {
+            daemonReply(client, "ERR unknown profile '%.64s'\n", name);
+            return;
+        }
+        if (countText != NULL && (parseNumber(countText, &count) != 0 || count < 1 || count > DAEMON_MAX_BATCH)) {
+            daemonReply(client, "ERR count must be between 1 and %d\n", DAEMON_MAX_BATCH);
+            return;
+        }
+        size_t replyStart = client->outputUsed;
+        daemonReply(client, "OK %llu\n", count);
+        if (client->closing || daemonReserve(client, (size_t)count * MAX_PASSWORD_LENGTH) != 0) {
+            client->closing = 1;
+            return;
+        }
+        for (unsigned long long i = 0; i < count; i++) {
+            char *dest = client->output + client->outputUsed;
+            int length = daemonTakePassword(state, p, dest);
+            if (length < 0) {
+                // Withdraw the partial reply and wipe what was taken
+                explicit_bzero(client->output + replyStart, client->outputUsed - replyStart);
+                client->outputUsed = replyStart;
+                daemonReply(client, "ERR no password of profile '%.64s' is outside the breach index\n", name);
+                return;
+            }
+            dest[length] = '\n';
+            client->outputUsed += (size_t)length + 1;
+        }
+    } else if (strcmp(command, "STATS") == 0) {
+        daemonReply(client, "OK %d\n", state->profileCount);
+        for (int p = 0; p < state->profileCount; p++) {
+            PasswordRing *ring = &state->rings[p];
+            size_t buffered = atomic_load(&ring->tail) - atomic_load(&ring->head);
+            daemonReply(client, "%s %zu %llu %llu\n", state->profiles[p].name, buffered,
+                        ring->served, ring->generatedInline);
+        }
+    } else {
+        daemonReply(client, "ERR unknown command '%.32s'\n", command);
+    }
 }
 
-// Get validated integer input
-int getValidatedInput(int min, int max) {
-    int choice;
-    while (scanf("%d", &choice) != 1 || choice < min || choice > max) {
-        while (getchar() != '\n'); // Clear input buffer
-        printf("  ❌ Invalid input! Please enter a number between %d and %d: ", min, max);
+// Send as much pending output as the socket takes; wipe what was sent
+static int daemonFlush(DaemonClient *client) {
+    while (client->outputSent < client->outputUsed) {
+        ssize_t sent = send(client->fd, client->output + client->outputSent,
+                            client->outputUsed - client->outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+        client->outputSent += (size_t)sent;
     }
-    while (getchar() != '\n'); // Clear newline from buffer
-    return choice;
+    explicit_bzero(client->output, client->outputUsed);
+    client->outputUsed = 0;
+    client->outputSent = 0;
+    return 0;
 }
 
-// Generate a single password
-void generatePassword(char *password, PasswordConfig config) {
-    char lowercase[] = "abcdefghijklmnopqrstuvwxyz";
-    char uppercase[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-    char digits[] = "0123456789";
-    char special[] = "!@#$%^&*-_+=[]{}|;:,.<>?";
-    
-    char charset[200] = "";
-    
-    // Build character set
-    if (config.useLower) strcat(charset, lowercase);
-    if (config.useUpper) strcat(charset, uppercase);
-    if (config.useDigits) strcat(charset, digits);
-    if (config.useSpecial) strcat(charset, special);
-    
-    // Generate password
-    for (int i = 0; i < config.length; i++) {
-        int randomIndex = rand() % strlen(charset);
-        password[i] = charset[randomIndex];
+// Drop a connection and wipe its buffers
+static void daemonCloseClient(int epollFd, DaemonClient *client) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    if (client->output != NULL) {
+        explicit_bzero(client->output, client->outputCapacity);
+        free(client->output);
     }
-    password[config.length] = '\0';
+    free(client);
 }
 
-// Evaluate password strength
-void showPasswordStrength(const char *password) {
-    int length = strlen(password);
-    int hasLower = 0, hasUpper = 0, hasDigit = 0, hasSpecial = 0;
-    
-    for (int i = 0; i < length; i++) {
-        if (islower(password[i])) hasLower = 1;
-        if (isupper(password[i])) hasUpper = 1;
-        if (isdigit(password[i])) hasDigit = 1;
-        if (!isalnum(password[i])) hasSpecial = 1;
+// Read what a client sent, answer complete lines and push the replies out
+static void daemonServeClient(DaemonState *state, int epollFd, DaemonClient *client, uint32_t events) {
+    if (events & EPOLLIN) {
+        for (;;) {
+            ssize_t got = read(client->fd, client->input + client->inputUsed,
+                               sizeof(client->input) - client->inputUsed);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) client->closing = 1;
+                break;
+            }
+            if (got == 0) {
+                client->closing = 1;
+                break;
+            }
+            client->inputUsed += (size_t)got;
+
+            char *lineStart = client->input;
+            char *newline;
+            while ((newline = memchr(lineStart, '\n', client->inputUsed - (size_t)(lineStart - client->input))) != NULL) {
+                *newline = '\0';
+                daemonHandleLine(state, client, lineStart);
+                lineStart = newline + 1;
+            }
+            client->inputUsed -= (size_t)(lineStart - client->input);
+            memmove(client->input, lineStart, client->inputUsed);
+            if (client->inputUsed == sizeof(client->input)) {
+                daemonReply(client, "ERR request line too long\n");
+                client->closing = 1;
+                break;
+            }
+            if (client->outputUsed >= (size_t)DAEMON_MAX_BATCH * MAX_PASSWORD_LENGTH) {
+                break;
+            }
+        }
     }
-    
-    int strength = hasLower + hasUpper + hasDigit + hasSpecial;
-    
-    printf("  Strength: ");
-    if (length < 8) {
-        printf("🔴 Weak (too short)\n");
-    } else if (strength == 4 && length >= 12) {
-        printf("🟢 Very Strong\n");
-    } else if (strength == 4 || length >= 12) {
-        printf("🟢 Strong\n");
-    } else if (strength >= 2) {
-        printf("🟡 Medium\n");
+    if (daemonFlush(client) != 0 || (events & (EPOLLHUP | EPOLLERR))) {
+        daemonCloseClient(epollFd, client);
+        return;
+    }
+    if (client->outputUsed > 0) {
+        // Wait for the socket to drain before reading more requests
+        struct epoll_event event = { .events = EPOLLOUT, .data.ptr = client };
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client->fd, &event);
+    } else if (client->closing) {
+        daemonCloseClient(epollFd, client);
     } else {
-        printf("🔴 Weak\n");
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client->fd, &event);
     }
 }
 
-// Display generated passwords
-void displayPasswords(PasswordList *list) {
-    if (list->count == 0) {
-        printf("  ❌ No passwords generated yet!\n");
-        return;
+// Serve passwords on a Unix socket until SIGINT or SIGTERM. One thread runs
+// the epoll loop; another keeps a ring of ready passwords per profile.
+int runDaemon(const CommandLineOptions *options) {
+    static DaemonState state;
+    int status = 1;
+    int listenFd = -1, epollFd = -1, signalFd = -1;
+    int bound = 0;
+    pthread_t refillThread;
+    int refillStarted = 0;
+
+    state.refillEvent = -1;
+
+    state.profileCount = 0;
+    strcpy(state.profiles[state.profileCount].name, "default");
+    state.profiles[state.profileCount++].config = options->config;
+    for (int i = 0; i < options->profileCount; i++) {
+        state.profiles[state.profileCount++] = options->profiles[i];
     }
-    
-    printf("\n  ╔════════════════════════════════════════════╗\n");
-    printf("  ║        GENERATED PASSWORDS (%d)            ║\n", list->count);
-    printf("  ╚════════════════════════════════════════════╝\n");
-    printSeparator();
-    
-    for (int i = 0; i < list->count; i++) {
-        printf("  Password %d: %s\n", i + 1, list->passwords[i]);
-        showPasswordStrength(list->passwords[i]);
-        printf("\n");
+    // The rings and both engines live in one secret arena
+    size_t ringBytes = (size_t)DAEMON_RING_SIZE * MAX_PASSWORD_LENGTH;
+    if (initSecretArena(&state.arena, (size_t)state.profileCount * ringBytes + 2 * sizeof(RandomEngine) + 128) != 0) {
+        fprintf(stderr, "Error: out of memory for the password rings\n");
+        return 1;
+    }
+    state.refillEngine = arenaAlloc(&state.arena, sizeof(RandomEngine), 64);
+    state.inlineEngine = arenaAlloc(&state.arena, sizeof(RandomEngine), 64);
+    if (initChaChaEngine(state.refillEngine) != 0 || initChaChaEngine(state.inlineEngine) != 0) {
+        fprintf(stderr, "Error: could not set up random engines\n");
+        goto cleanup;
+    }
+    for (int p = 0; p < state.profileCount; p++) {
+        compileCharset(&state.rings[p].charset, &state.profiles[p].config);
+        state.rings[p].slots = arenaAlloc(&state.arena, ringBytes, 64);
+    }
+
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    if (strlen(options->daemonPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Error: socket path '%s' is too long\n", options->daemonPath);
+        goto cleanup;
+    }
+    strcpy(address.sun_path, options->daemonPath);
+
+    // Replace a stale socket from an earlier run, but never a regular file
+    struct stat info;
+    if (lstat(options->daemonPath, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(options->daemonPath);
+    }
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    mode_t oldMask = umask(0077);
+    bound = listenFd >= 0 && bind(listenFd, (struct sockaddr *)&address, sizeof(address)) == 0;
+    umask(oldMask);
+    if (!bound || listen(listenFd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Error: could not listen on '%s': %s\n", options->daemonPath, strerror(errno));
+        goto cleanup;
+    }
+
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, NULL);
+    signalFd = signalfd(-1, &stopSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    state.refillEvent = eventfd(0, EFD_CLOEXEC);
+    if (signalFd < 0 || epollFd < 0 || state.refillEvent < 0) {
+        fprintf(stderr, "Error: could not set up the event loop: %s\n", strerror(errno));
+        goto cleanup;
+    }
+    struct epoll_event listenEvent = { .events = EPOLLIN, .data.ptr = &listenFd };
+    struct epoll_event signalEvent = { .events = EPOLLIN, .data.ptr = &signalFd };
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent);
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &signalEvent);
+
+    // The rings are filled before the first request is accepted
+    atomic_store(&state.stopping, 0);
+    if (pthread_create(&refillThread, NULL, daemonRefillThread, &state) != 0) {
+        fprintf(stderr, "Error: could not start the refill thread\n");
+        goto cleanup;
+    }
+    refillStarted = 1;
+    fprintf(stderr, "Serving %d profile(s) on '%s'\n", state.profileCount, options->daemonPath);
+
+    int running = 1;
+    while (running) {
+        struct epoll_event events[64];
+        int ready = epoll_wait(epollFd, events, 64, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+        for (int e = 0; e < ready; e++) {
+            if (events[e].data.ptr == &signalFd) {
+                running = 0;
+            } else if (events[e].data.ptr == &listenFd) {
+                int fd;
+                while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    DaemonClient *client = calloc(1, sizeof(DaemonClient));
+                    struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+                    if (client == NULL || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                        free(client);
+                        close(fd);
+                        continue;
+                    }
+                    client->fd = fd;
+                }
+            } else {
+                daemonServeClient(&state, epollFd, events[e].data.ptr, events[e].events);
+            }
+        }
+    }
+    status = 0;
+    fprintf(stderr, "Shutting down\n");
+
+cleanup:
+    if (refillStarted) {
+        uint64_t one = 1;
+        atomic_store(&state.stopping, 1);
+        if (write(state.refillEvent, &one, sizeof(one)) < 0) {
+            // The thread still sees the flag after its current ring
+        }
+        pthread_join(refillThread, NULL);
     }
+    if (listenFd >= 0) close(listenFd);
+    if (bound) unlink(options->daemonPath);
+    if (epollFd >= 0) close(epollFd);
+    if (signalFd >= 0) close(signalFd);
+    if (state.refillEvent >= 0) close(state.refillEvent);
+    destroySecretArena(&state.arena);
+    return status;
 }
 
-// Get user settings
-void getUserSettings(PasswordConfig *config) {
-    displayCharacterMenu();
-    
-    printf("  Include lowercase letters (a-z)? (1/0): ");
-    config->useLower = getValidatedInput(0, 1);
-    
-    printf("  Include uppercase letters (A-Z)? (1/0): ");
-    config->useUpper = getValidatedInput(0, 1);
-    
-    printf("  Include digits (0-9)? (1/0): ");
-    config->useDigits = getValidatedInput(0, 1);
-    
-    printf("  Include special characters (!@#$%%)? (1/0): ");
-    config->useSpecial = getValidatedInput(0, 1);
-    
-    if (!config->useLower && !config->useUpper && !config->useDigits && !config->useSpecial) {
-        printf("\n  ⚠️  Warning: Select at least one character type!\n");
-        printf("  Using default: Uppercase + Lowercase + Digits\n");
-        config->useLower = 1;
-        config->useUpper = 1;
-        config->useDigits = 1;
+// Print command line usage
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  Without options the interactive menu is started; otherwise the options\n");
+    fprintf(stderr, "  print one password, or --count of them, and never prompt.\n\n");
+    fprintf(stderr, "  --count N        Generate N passwords non-interactively (bulk mode)\n");
+    fprintf(stderr, "  --menu           Start the interactive menu with the settings given\n");
+    fprintf(stderr, "  --length L       Password length (1-%d, default 12)\n", MAX_PASSWORD_LENGTH - 1);
+    fprintf(stderr, "  --output FILE    Write to FILE instead of stdout\n");
+    fprintf(stderr, "  --format F       Bulk output format: plain, csv, jsonl or binary (default plain)\n");
+    fprintf(stderr, "  --direct         Write the --output file with O_DIRECT, bypassing the page cache\n");
+    fprintf(stderr, "  --threads N      Worker threads for bulk and audit modes (default: all CPUs)\n");
+    fprintf(stderr, "  --ordered        Write bulk chunks in generation order\n");
+    fprintf(stderr, "  --seed HEX       Deterministic mode: derive passwords from a seed of up to 64 hex digits\n");
+    fprintf(stderr, "  --start I        With --seed, first password index to generate (default 0)\n");
+    fprintf(stderr, "  --verify PW      With --seed, check that PW is password --start\n");
+    fprintf(stderr, "  --wordlist FILE  Generate passphrases from FILE (one word per line, EFF format ok)\n");
+    fprintf(stderr, "  --words N        Words per passphrase (default 6)\n");
+    fprintf(stderr, "  --separator C    Character between passphrase words (default '-')\n");
+    fprintf(stderr, "  --markov MODEL   Generate pronounceable passwords from a trained letter model\n");
+    fprintf(stderr, "                   (lowercase letters, word starts capitalized unless --no-upper)\n");
+    fprintf(stderr, "  --train-markov CORPUS\n");
+    fprintf(stderr, "                   Train a letter model on a text corpus into the --output file\n");
+    fprintf(stderr, "  --unique         In bulk mode, never emit the same password twice\n");
+    fprintf(stderr, "  --unique-memory M\n");
+    fprintf(stderr, "                   Memory cap for --unique in MiB (default %d, up to 22 bytes per password)\n",
+            UNIQUE_DEFAULT_MEMORY);
+    fprintf(stderr, "  --min-lower N    Require at least N lowercase letters (also --min-upper,\n");
+    fprintf(stderr, "                   --min-digits, --min-special)\n");
+    fprintf(stderr, "  --no-repeat      Never emit the same character twice in a row\n");
+    fprintf(stderr, "  --no-lower       Exclude lowercase letters\n");
+    fprintf(stderr, "  --no-upper       Exclude uppercase letters\n");
+    fprintf(stderr, "  --no-digits      Exclude digits\n");
+    fprintf(stderr, "  --no-special     Exclude special characters\n");
+    fprintf(stderr, "  --audit FILE     Print the strength histogram of a newline-separated password file\n");
+    fprintf(stderr, "  --no-simd        Use the scalar classifier in --audit\n");
+    fprintf(stderr, "  --breach-index F Reject generated passwords found in index F and flag them in reports\n");
+    fprintf(stderr, "  --build-breach-index CORPUS\n");
+    fprintf(stderr, "                   Build an index from SHA-1 hex lines into the --output file\n");
+    fprintf(stderr, "  --daemon SOCKET  Serve \"GET <profile> [count]\" requests on a Unix socket\n");
+    fprintf(stderr, "                   from pre-generated pools; the options above form profile 'default'\n");
+    fprintf(stderr, "  --profile NAME:LENGTH[:CLASSES]\n");
+    fprintf(stderr, "                   Add a daemon profile; CLASSES is any of l, u, d, s (default all)\n");
+    fprintf(stderr, "  --help           Show this help\n");
+}
+
+// Parse a non-negative decimal number, rejecting trailing garbage
+static int parseNumber(const char *text, unsigned long long *value) {
+    char *end;
+    if (text == NULL || *text == '\0' || *text == '-') return -1;
+    errno = 0;
+    *value = strtoull(text, &end, 10);
+    return (errno != 0 || *end != '\0') ? -1 : 0;
+}
+
+// Parse a daemon profile "name:length[:classes]", classes from "luds"
+static int parseProfile(const char *text, DaemonProfile *profile) {
+    unsigned long long length;
+    char lengthText[16];
+    const char *colon = text ? strchr(text, ':') : NULL;
+    if (colon == NULL || colon == text || (size_t)(colon - text) >= sizeof(profile->name)) return -1;
+
+    memset(profile, 0, sizeof(*profile));
+    memcpy(profile->name, text, (size_t)(colon - text));
+    const char *classes = strchr(colon + 1, ':');
+    size_t lengthDigits = classes ? (size_t)(classes - colon - 1) : strlen(colon + 1);
+    if (lengthDigits == 0 || lengthDigits >= sizeof(lengthText)) return -1;
+    memcpy(lengthText, colon + 1, lengthDigits);
+    lengthText[lengthDigits] = '\0';
+    if (parseNumber(lengthText, &length) != 0 || length < 1 || length > MAX_PASSWORD_LENGTH - 1) return -1;
+
+    profile->config = (PasswordConfig){(int)length, 1, 1, 1, 1, PASSWORD_MODE_RANDOM, 6, '-'};
+    if (classes != NULL) {
+        classes++;
+        if (*classes == '\0' || strspn(classes, "luds") != strlen(classes)) return -1;
+        profile->config.useLower = strchr(classes, 'l') != NULL;
+        profile->config.useUpper = strchr(classes, 'u') != NULL;
+        profile->config.useDigits = strchr(classes, 'd') != NULL;
+        profile->config.useSpecial = strchr(classes, 's') != NULL;
     }
-    
-    printf("\n  ✓ Settings updated!\n");
+    return 0;
 }
 
-// Save passwords to file
-void savePasswordsToFile(PasswordList *list) {
-    if (list->count == 0) {
-        printf("\n  ❌ No passwords to save!\n");
-        return;
+// Parse a hex seed into a ChaCha20 key; shorter seeds are zero padded
+static int parseSeed(const char *text, uint32_t key[8]) {
+    size_t digits = text ? strlen(text) : 0;
+    if (digits == 0 || digits > 64) return -1;
+
+    memset(key, 0, 8 * sizeof(uint32_t));
+    for (size_t i = 0; i < digits; i++) {
+        int c = tolower((unsigned char)text[i]);
+        int nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else return -1;
+        // Digits are read as bytes in order, high nibble first
+        size_t byte = i / 2;
+        int shift = 8 * (int)(byte % 4) + ((i % 2) ? 0 : 4);
+        key[byte / 4] |= (uint32_t)nibble << shift;
     }
-    
-    FILE *file = fopen("generated_passwords.txt", "w");
-    if (file == NULL) {
-        printf("\n  ❌ Error: Could not create file!\n");
-        return;
+    return 0;
+}
+
+// Parse command line flags; returns 0 on success, 1 for --help, -1 on error
+int parseCommandLine(int argc, char *argv[], CommandLineOptions *options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        unsigned long long number;
+
+        if (strcmp(arg, "--count") == 0) {
+            if (parseNumber(value, &number) != 0) {
+                fprintf(stderr, "Error: --count expects a number\n");
+                return -1;
+            }
+            options->count = number;
+            options->bulk = 1;
+            i++;
+        } else if (strcmp(arg, "--length") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number >= MAX_PASSWORD_LENGTH) {
+                fprintf(stderr, "Error: --length expects a number between 1 and %d\n", MAX_PASSWORD_LENGTH - 1);
+                return -1;
+            }
+            options->config.length = (int)number;
+            i++;
+        } else if (strcmp(arg, "--output") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: --output expects a file name\n");
+                return -1;
+            }
+            options->outputPath = value;
+            i++;
+        } else if (strcmp(arg, "--format") == 0) {
+            int found = -1;
+            for (int f = 0; value != NULL && f < 4; f++) {
+                if (strcmp(value, formatNames[f]) == 0) found = f;
+            }
+            if (found < 0) {
+                fprintf(stderr, "Error: --format expects plain, csv, jsonl or binary\n");
+                return -1;
+            }
+            options->format = (OutputFormat)found;
+            i++;
+        } else if (strcmp(arg, "--direct") == 0) {
+            options->directIo = 1;
+        } else if (strcmp(arg, "--threads") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number > 1024) {
+                fprintf(stderr, "Error: --threads expects a number between 1 and 1024\n");
+                return -1;
+            }
+            options->threads = (int)number;
+            i++;
+        } else if (strcmp(arg, "--ordered") == 0) {
+            options->ordered = 1;
+        } else if (strcmp(arg, "--seed") == 0) {
+            if (parseSeed(value, options->seedKey) != 0) {
+                fprintf(stderr, "Error: --seed expects 1 to 64 hex digits\n");
+                return -1;
+            }
+            options->seeded = 1;
+            i++;
+        } else if (strcmp(arg, "--start") == 0) {
+            if (parseNumber(value, &number) != 0) {
+                fprintf(stderr, "Error: --start expects a number\n");
+                return -1;
+            }
+            options->start = number;
+            i++;
+        } else if (strcmp(arg, "--verify") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: --verify expects a password\n");
+                return -1;
+            }
+            options->verifyPassword = value;
+            i++;
+        } else if (strcmp(arg, "--min-lower") == 0 || strcmp(arg, "--min-upper") == 0 ||
+                   strcmp(arg, "--min-digits") == 0 || strcmp(arg, "--min-special") == 0) {
+            if (parseNumber(value, &number) != 0 || number >= MAX_PASSWORD_LENGTH) {
+                fprintf(stderr, "Error: %s expects a number below %d\n", arg, MAX_PASSWORD_LENGTH);
+                return -1;
+            }
+            if (arg[6] == 'l') options->policy.minLower = (int)number;
+            else if (arg[6] == 'u') options->policy.minUpper = (int)number;
+            else if (arg[6] == 'd') options->policy.minDigits = (int)number;
+            else options->policy.minSpecial = (int)number;
+            options->usePolicy = 1;
+            i++;
+        } else if (strcmp(arg, "--wordlist") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: --wordlist expects a file name\n");
+                return -1;
+            }
+            options->wordlistPath = value;
+            options->config.mode = PASSWORD_MODE_PASSPHRASE;
+            i++;
+        } else if (strcmp(arg, "--markov") == 0 || strcmp(arg, "--train-markov") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: %s expects a file name\n", arg);
+                return -1;
+            }
+            if (arg[2] == 't') {
+                options->markovCorpusPath = value;
+            } else {
+                options->markovPath = value;
+                options->config.mode = PASSWORD_MODE_PRONOUNCEABLE;
+            }
+            i++;
+        } else if (strcmp(arg, "--daemon") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: --daemon expects a socket path\n");
+                return -1;
+            }
+            options->daemonPath = value;
+            i++;
+        } else if (strcmp(arg, "--profile") == 0) {
+            if (options->profileCount == DAEMON_MAX_PROFILES) {
+                fprintf(stderr, "Error: at most %d --profile options are supported\n", DAEMON_MAX_PROFILES);
+                return -1;
+            }
+            if (parseProfile(value, &options->profiles[options->profileCount]) != 0) {
+                fprintf(stderr, "Error: --profile expects NAME:LENGTH[:CLASSES], CLASSES drawn from 'luds'\n");
+                return -1;
+            }
+            options->profileCount++;
+            i++;
+        } else if (strcmp(arg, "--words") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number > 64) {
+                fprintf(stderr, "Error: --words expects a number between 1 and 64\n");
+                return -1;
+            }
+            options->config.wordCount = (int)number;
+            i++;
+        } else if (strcmp(arg, "--separator") == 0) {
+            if (value == NULL || strlen(value) != 1) {
+                fprintf(stderr, "Error: --separator expects a single character\n");
+                return -1;
+            }
+            options->config.separator = value[0];
+            i++;
+        } else if (strcmp(arg, "--unique") == 0) {
+            options->unique = 1;
+        } else if (strcmp(arg, "--unique-memory") == 0) {
+            if (parseNumber(value, &number) != 0 || number < 1 || number > (1ULL << 20)) {
+                fprintf(stderr, "Error: --unique-memory expects a size in MiB\n");
+                return -1;
+            }
+            options->uniqueMemory = number;
+            i++;
+        } else if (strcmp(arg, "--no-repeat") == 0) {
+            options->policy.noRepeats = 1;
+            options->usePolicy = 1;
+        } else if (strcmp(arg, "--no-lower") == 0) {
+            options->config.useLower = 0;
+        } else if (strcmp(arg, "--no-upper") == 0) {
+            options->config.useUpper = 0;
+        } else if (strcmp(arg, "--no-digits") == 0) {
+            options->config.useDigits = 0;
+        } else if (strcmp(arg, "--no-special") == 0) {
+            options->config.useSpecial = 0;
+        } else if (strcmp(arg, "--audit") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: --audit expects a file name\n");
+                return -1;
+            }
+            options->auditPath = value;
+            i++;
+        } else if (strcmp(arg, "--breach-index") == 0 || strcmp(arg, "--build-breach-index") == 0) {
+            if (value == NULL) {
+                fprintf(stderr, "Error: %s expects a file name\n", arg);
+                return -1;
+            }
+            if (arg[2] == 'b' && arg[3] == 'u') options->breachCorpusPath = value;
+            else options->breachIndexPath = value;
+            i++;
+        } else if (strcmp(arg, "--no-simd") == 0) {
+            options->noSimd = 1;
+        } else if (strcmp(arg, "--menu") == 0) {
+            options->menu = 1;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            return 1;
+        } else {
+            fprintf(stderr, "Error: unknown option '%s'\n", arg);
+            return -1;
+        }
     }
-    
-    fprintf(file, "═══════════════════════════════════════════\n");
-    fprintf(file, "       PASSWORD GENERATOR - OUTPUT\n");
-    fprintf(file, "═══════════════════════════════════════════\n\n");
-    
-    for (int i = 0; i < list->count; i++) {
-        fprintf(file, "Password %d: %s\n", i + 1, list->passwords[i]);
+
+    if (!options->config.useLower && !options->config.useUpper &&
+        !options->config.useDigits && !options->config.useSpecial) {
+        fprintf(stderr, "Error: at least one character type must be enabled\n");
+        return -1;
     }
-    
-    fprintf(file, "\n═══════════════════════════════════════════\n");
-    fprintf(file, "Generated on: ");
-    time_t now = time(NULL);
-    fprintf(file, "%s", ctime(&now));
-    
-    fclose(file);
-    printf("\n  ✓ Passwords saved to 'generated_passwords.txt'\n");
+    if (options->usePolicy) {
+        const PasswordPolicy *policy = &options->policy;
+        if ((policy->minLower && !options->config.useLower) ||
+            (policy->minUpper && !options->config.useUpper) ||
+            (policy->minDigits && !options->config.useDigits) ||
+            (policy->minSpecial && !options->config.useSpecial)) {
+            fprintf(stderr, "Error: a --min-* option requires its character type to be enabled\n");
+            return -1;
+        }
+        if (policy->minLower + policy->minUpper + policy->minDigits + policy->minSpecial > options->config.length) {
+            fprintf(stderr, "Error: the --min-* counts add up to more than --length\n");
+            return -1;
+        }
+        if (options->seeded) {
+            fprintf(stderr, "Error: --seed cannot be combined with --min-* or --no-repeat\n");
+            return -1;
+        }
+    }
+    if (options->breachCorpusPath && (options->outputPath == NULL || strcmp(options->outputPath, "-") == 0)) {
+        fprintf(stderr, "Error: --build-breach-index needs --output INDEX_FILE\n");
+        return -1;
+    }
+    if (options->markovCorpusPath && (options->outputPath == NULL || strcmp(options->outputPath, "-") == 0)) {
+        fprintf(stderr, "Error: --train-markov needs --output MODEL_FILE\n");
+        return -1;
+    }
+    if (options->config.mode != PASSWORD_MODE_RANDOM && (options->usePolicy || options->seeded)) {
+        fprintf(stderr, "Error: --wordlist and --markov cannot be combined with --seed, --min-* or --no-repeat\n");
+        return -1;
+    }
+    if (options->daemonPath && (options->usePolicy || options->seeded)) {
+        fprintf(stderr, "Error: --daemon cannot be combined with --seed, --min-* or --no-repeat\n");
+        return -1;
+    }
+    if (options->unique && options->seeded) {
+        // Redrawing a duplicate would break the index -> password mapping
+        fprintf(stderr, "Error: --unique cannot be combined with --seed\n");
+        return -1;
+    }
+    if (options->unique && options->count == 0) {
+        fprintf(stderr, "Error: --unique applies to bulk mode; add --count N\n");
+        return -1;
+    }
+    if (options->profileCount > 0 && options->daemonPath == NULL) {
+        fprintf(stderr, "Error: --profile requires --daemon\n");
+        return -1;
+    }
+    if ((options->start > 0 || options->verifyPassword) && !options->seeded) {
+        fprintf(stderr, "Error: --start and --verify require --seed\n");
+        return -1;
+    }
+    if (options->seeded) {
+        // Reproducible output also needs a reproducible order
+        options->ordered = 1;
+    }
+    return 0;
 }
 
 // Display about information
@@ -258,20 +3670,119 @@ void displayAbout() {
     getchar();
 }
 
+#ifndef PASSWORD_GENERATOR_LIBRARY
+static const char *formatExtensions[] = {"txt", "csv", "jsonl", "bin"};
+
 // Main program
-int main() {
-    srand(time(0));
-    
+int main(int argc, char *argv[]) {
     PasswordConfig config = {
         .length = 12,
         .useLower = 1,
         .useUpper = 1,
         .useDigits = 1,
-        .useSpecial = 1
+        .useSpecial = 1,
+        .mode = PASSWORD_MODE_RANDOM,
+        .wordCount = 6,
+        .separator = '-'
     };
     
+    if (argc > 1) {
+        CommandLineOptions options = {
+            .config = config,
+            .count = 0,
+            .outputPath = NULL,
+            .format = FORMAT_PLAIN,
+            .directIo = 0,
+            .bulk = 0,
+            .threads = 1,
+            .ordered = 0,
+            .policy = {0, 0, 0, 0, 0},
+            .usePolicy = 0,
+            .seeded = 0,
+            .start = 0,
+            .verifyPassword = NULL,
+            .auditPath = NULL,
+            .noSimd = 0,
+            .breachIndexPath = NULL,
+            .breachCorpusPath = NULL,
+            .wordlistPath = NULL,
+            .markovPath = NULL,
+            .markovCorpusPath = NULL,
+            .daemonPath = NULL,
+            .profileCount = 0,
+            .unique = 0,
+            .uniqueMemory = UNIQUE_DEFAULT_MEMORY,
+            .menu = 0
+        };
+        
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cpus > 1) {
+            options.threads = cpus > 1024 ? 1024 : (int)cpus;
+        }
+        
+        int parsed = parseCommandLine(argc, argv, &options);
+        if (parsed != 0) {
+            printUsage(argv[0]);
+            return parsed > 0 ? 0 : 1;
+        }
+        if (options.breachCorpusPath) {
+            return buildBreachIndex(options.breachCorpusPath, options.outputPath);
+        }
+        if (options.markovCorpusPath) {
+            return trainMarkovModel(options.markovCorpusPath, options.outputPath);
+        }
+        if (options.breachIndexPath) {
+            if (loadBreachIndex(options.breachIndexPath) != 0) {
+                fprintf(stderr, "Error: could not load breach index '%s': %s\n",
+                        options.breachIndexPath, strerror(errno));
+                return 1;
+            }
+        }
+        if (options.wordlistPath) {
+            if (loadWordlist(options.wordlistPath) != 0) {
+                fprintf(stderr, "Error: could not load wordlist '%s': %s\n",
+                        options.wordlistPath, strerror(errno));
+                return 1;
+            }
+            if (options.config.wordCount * (loadedWordlist.longestWord + 1) > MAX_PASSWORD_LENGTH) {
+                fprintf(stderr, "Error: %d words of up to %d characters may exceed %d characters; use fewer --words\n",
+                        options.config.wordCount, loadedWordlist.longestWord, MAX_PASSWORD_LENGTH - 1);
+                return 1;
+            }
+        }
+        if (options.markovPath) {
+            if (loadMarkovModel(options.markovPath) != 0) {
+                fprintf(stderr, "Error: could not load letter model '%s': %s\n",
+                        options.markovPath, strerror(errno));
+                return 1;
+            }
+        }
+        if (options.daemonPath) {
+            return runDaemon(&options);
+        }
+        if (options.verifyPassword) {
+            return runVerify(&options);
+        }
+        if (options.auditPath) {
+            return runAudit(&options);
+        }
+        if (options.bulk || !options.menu) {
+            // Options without --count or --menu print a single password
+            if (!options.bulk) options.count = 1;
+            return runBulkGeneration(&options);
+        }
+        config = options.config;
+    }
+    
+    // Room for a full list at the longest length, plus generation scratch
+    static SecretArena listArena;
+    if (initSecretArena(&listArena, (MAX_PASSWORDS + 1) * MAX_PASSWORD_LENGTH) != 0) {
+        fprintf(stderr, "Error: could not allocate password memory: %s\n", strerror(errno));
+        return 1;
+    }
     PasswordList passwordList = {
-        .count = 0
+        .count = 0,
+        .arena = &listArena
     };
     
     int running = 1;
@@ -293,10 +3804,24 @@ int main() {
                 
                 printf("\n  ⏳ Generating %d password(s)...\n", count);
                 
-                passwordList.count = count;
+                CompiledCharset charset;
+                compileCharset(&charset, &config);
+                
+                // Drop (and wipe) the previous list, then store each password
+                // at its real length
+                resetSecretArena(&listArena);
+                char *scratch = arenaAlloc(&listArena, MAX_PASSWORD_LENGTH, 1);
+                passwordList.count = 0;
                 for (int i = 0; i < count; i++) {
-                    generatePassword(passwordList.passwords[i], config);
+                    int length = generateConfiguredPassword(scratch, &config, &charset, NULL, getDefaultRandomEngine());
+                    if (length < 0) {
+                        printf("\n  ❌ Every password drawn was in the breach index; widen the character set.\n");
+                        break;
+                    }
+                    passwordList.passwords[i] = arenaCopy(&listArena, scratch, (size_t)length);
+                    passwordList.count = i + 1;
                 }
+                explicit_bzero(scratch, MAX_PASSWORD_LENGTH);
                 
                 displayPasswords(&passwordList);
                 printf("  Press Enter to continue...");
@@ -308,13 +3833,13 @@ int main() {
                 int settingsRunning = 1;
                 while (settingsRunning) {
                     displaySettingsMenu(&config);
-                    int settingsChoice = getValidatedInput(1, 4);
+                    int settingsChoice = getValidatedInput(1, 5);
                     
                     switch (settingsChoice) {
                         case 1: {
                             clearScreen();
-                            printf("\n  Enter password length (8-128): ");
-                            config.length = getValidatedInput(8, 128);
+                            printf("\n  Enter password length (8-%d): ", MAX_PASSWORD_LENGTH - 1);
+                            config.length = getValidatedInput(8, MAX_PASSWORD_LENGTH - 1);
                             printf("  ✓ Length updated to %d!\n", config.length);
                             printf("  Press Enter to continue...");
                             getchar();
@@ -327,13 +3852,30 @@ int main() {
                             break;
                         }
                         case 3: {
-                            config = (PasswordConfig){12, 1, 1, 1, 1};
+                            config = (PasswordConfig){12, 1, 1, 1, 1, PASSWORD_MODE_RANDOM, 6, '-'};
                             printf("\n  ✓ Settings reset to default!\n");
                             printf("  Press Enter to continue...");
                             getchar();
                             break;
                         }
-                        case 4:
+                        case 4: {
+                            // Cycle through the modes whose data was loaded at startup
+                            int previous = config.mode;
+                            do {
+                                config.mode = (config.mode + 1) % 3;
+                            } while ((config.mode == PASSWORD_MODE_PASSPHRASE && activeWordlist == NULL) ||
+                                     (config.mode == PASSWORD_MODE_PRONOUNCEABLE && activeMarkovModel == NULL));
+                            if (config.mode == previous) {
+                                printf("\n  ❌ No other mode available! Start with --wordlist FILE or --markov MODEL.\n");
+                            } else {
+                                static const char *modeNames[] = {"Random characters", "Passphrase", "Pronounceable"};
+                                printf("\n  ✓ Mode switched to %s!\n", modeNames[config.mode]);
+                            }
+                            printf("  Press Enter to continue...");
+                            getchar();
+                            break;
+                        }
+                        case 5:
                             settingsRunning = 0;
                             break;
                     }
@@ -344,7 +3886,18 @@ int main() {
             case 3: {
                 clearScreen();
                 printSeparator();
-                savePasswordsToFile(&passwordList);
+                printf("  Choose a file format:\n");
+                printf("  1. Text report (generated_passwords.txt)\n");
+                printf("  2. Plain lines (generated_passwords.txt)\n");
+                printf("  3. CSV (generated_passwords.csv)\n");
+                printf("  4. JSON Lines (generated_passwords.jsonl)\n");
+                printf("  5. Binary, length-prefixed (generated_passwords.bin)\n");
+                printf("\n  Enter your choice (1-5): ");
+                int format = getValidatedInput(1, 5) - 2;
+                char path[64];
+                snprintf(path, sizeof(path), "generated_passwords.%s",
+                         format < 0 ? "txt" : formatExtensions[format]);
+                savePasswordsToFile(&passwordList, path, format);
                 printf("  Press Enter to continue...");
                 getchar();
                 break;
@@ -369,5 +3922,7 @@ int main() {
         }
     }
     
+    destroySecretArena(&listArena);
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,65 @@
+#ifndef PASSWORD_GENERATOR_H
+#define PASSWORD_GENERATOR_H
+
+#include <stddef.h>
+
+// Library interface of password_generator.c. Build the file with
+// -DPASSWORD_GENERATOR_LIBRARY to leave out main() and link it into your own
+// program; generation never forks, execs or touches the terminal.
+
+#define MAX_PASSWORD_LENGTH 128
+
+typedef struct {
+    int length;
+    int useLower;
+    int useUpper;
+    int useDigits;
+    int useSpecial;
+    int mode;
+    int wordCount;
+    char separator;
+} PasswordConfig;
+
+// PasswordConfig.mode: random characters, or words from the loaded wordlist
+#define PASSWORD_MODE_RANDOM     0
+#define PASSWORD_MODE_PASSPHRASE 1
+#define PASSWORD_MODE_PRONOUNCEABLE 2
+
+// Minimum number of characters per class, and whether the same character
+// may appear twice in a row
+typedef struct {
+    int minLower;
+    int minUpper;
+    int minDigits;
+    int minSpecial;
+    int noRepeats;
+} PasswordPolicy;
+
+struct SecretArena;
+
+// Passwords from generatePasswordBatch(): passwords[i] is a NUL-terminated
+// string of lengths[i] characters. Everything lives in one locked,
+// guard-paged block that freePasswordBatch() wipes.
+typedef struct {
+    char **passwords;
+    int *lengths;
+    size_t count;
+    struct SecretArena *memory;
+} PasswordBatch;
+
+// Generate count passwords for config (policy may be NULL). Returns 0, or -1
+// with errno set (EINVAL for an unusable config, EAGAIN if every draw of a
+// password was in the breach index, ENOMEM, or the entropy source's error).
+// Safe to call from several threads at once.
+int generatePasswordBatch(const PasswordConfig *config, const PasswordPolicy *policy,
+                          size_t count, PasswordBatch *batch);
+void freePasswordBatch(PasswordBatch *batch);
+
+// Load the data of passphrase and pronounceable mode, or a breach index
+// whose passwords are redrawn; returns 0, or -1 with errno set. Call before
+// generating, not while other threads generate.
+int loadWordlist(const char *path);
+int loadMarkovModel(const char *path);
+int loadBreachIndex(const char *path);
+
+#endif